@@ -2,11 +2,74 @@
 #define CV_JOB_MATCHER_HPP
 
 #include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+class MatchEngine;
+class Embedder;
+struct EmbedderConfig;
+struct MatchOptions;
+
+// Description characters the CLI shows per match, and all that a
+// preview-only match reads from the database
+const size_t DESCRIPTION_PREVIEW_CHARS = 200;
+
+// A job row hydrated from the database together with its match scores
+struct Job {
+    int id = 0;
+    std::string title;
+    std::string description;
+    std::string location;
+    std::string source;
+    std::vector<std::string> skills;
+    float similarity = 0.0f;           // Combined score used for ranking
+    float embedding_similarity = 0.0f; // Raw cosine similarity to the CV
+    float keyword_relevance = 0.0f;    // BM25 skill/title relevance, scaled to [0, 1] per query
+};
+
+// Serialise a match in the same layout job_matcher.py produced
+void to_json(nlohmann::json& j, const Job& job);
+
+// Load a CV embedding written by embedder.py (a flat JSON array of floats).
+// The file is parsed as a stream straight into the vector, reserved for
+// dimension_hint values when known, without building a JSON document.
+// With sections given, a multi-vector CV (an array of equal-length arrays,
+// one per CV section) is also accepted: its rows are returned back to back
+// and *sections receives the row count, 1 for a flat array.
+// Returns an empty vector on failure.
+std::vector<float> load_cv_embedding(const std::string& cv_embedding_path, size_t dimension_hint = 0,
+                                     size_t* sections = nullptr);
+
+// Write matches to a JSON file, creating parent directories as needed
+bool save_matches_to_json(const std::vector<Job>& matches, const std::string& output_path);
+
+// Print matches to stdout in the format used by the CLI
+void print_matches(const std::vector<Job>& matches);
 
 // Function to match a CV embedding with jobs from the database
-void match_cv_with_jobs(const std::string& cv_embedding_path, 
+void match_cv_with_jobs(const std::string& cv_embedding_path,
                        const std::string& db_path,
                        const std::string& faiss_index_path,
                        int top_k);
 
-#endif // CV_JOB_MATCHER_HPP
\ No newline at end of file
+// Same, against an engine that has already loaded the job index. cv_text,
+// when given, adds keyword relevance to the ranking.
+void match_cv_with_jobs(const std::string& cv_embedding_path,
+                        const MatchEngine& engine,
+                        const MatchOptions& options,
+                        const std::string& cv_text = std::string());
+
+// Match a backlog of CVs with one batched index search. batch_path is either
+// a directory of CV files or a manifest listing one file per line (relative
+// paths resolve against the manifest's directory). .json files are
+// precomputed embeddings; .txt files are CV text, embedded together in one
+// batch when an embedder is given, and their text also feeds keyword
+// relevance. Results for every CV go to output_path.
+void match_cv_batch(const std::string& batch_path,
+                    const MatchEngine& engine,
+                    const MatchOptions& options,
+                    const std::string& output_path,
+                    Embedder* embedder = nullptr,
+                    const EmbedderConfig* embedder_config = nullptr);
+
+#endif // CV_JOB_MATCHER_HPP
@@ -0,0 +1,372 @@
+#include "cv_embedder.hpp"
+#include "cv_job_matcher.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// Cohere accepts at most this many texts per embed request
+const size_t COHERE_MAX_BATCH = 96;
+
+static size_t WriteCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    static_cast<std::string*>(userp)->append(static_cast<char*>(contents), size * nmemb);
+    return size * nmemb;
+}
+
+static void ensure_curl_initialized() {
+    static std::once_flag once;
+    std::call_once(once, [] { curl_global_init(CURL_GLOBAL_DEFAULT); });
+}
+
+// POST a JSON body and return the HTTP status, or -1 on a transport error
+static long post_json(CURL* curl, const std::string& url, const std::string& body,
+                      const std::vector<std::string>& headers, long timeout_seconds,
+                      std::string& response) {
+    struct curl_slist* header_list = nullptr;
+    for (const auto& header : headers) {
+        header_list = curl_slist_append(header_list, header.c_str());
+    }
+
+    response.clear();
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_POST, 1L);
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body.c_str());
+    curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, static_cast<long>(body.size()));
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, header_list);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout_seconds);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
+
+    CURLcode res = curl_easy_perform(curl);
+    long status = -1;
+    if (res == CURLE_OK) {
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    } else {
+        response = curl_easy_strerror(res);
+    }
+
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, nullptr);
+    curl_slist_free_all(header_list);
+    return status;
+}
+
+CohereEmbedder::CohereEmbedder(const EmbedderConfig& config) : config_(config) {
+    if (config_.api_key.empty()) {
+        const char* env_key = std::getenv("COHERE_API_KEY");
+        config_.api_key = env_key ? env_key : "";
+    }
+    ensure_curl_initialized();
+    curl_ = curl_easy_init();
+}
+
+CohereEmbedder::~CohereEmbedder() {
+    if (curl_) {
+        curl_easy_cleanup(static_cast<CURL*>(curl_));
+    }
+}
+
+bool CohereEmbedder::embed(const std::vector<std::string>& texts,
+                           std::vector<std::vector<float>>& embeddings) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    embeddings.clear();
+    embeddings.reserve(texts.size());
+
+    CURL* curl = static_cast<CURL*>(curl_);
+    if (!curl) {
+        std::cerr << "[Embedder] Failed to initialize CURL\n";
+        return false;
+    }
+    if (config_.api_key.empty()) {
+        std::cerr << "[Embedder] No Cohere API key; set COHERE_API_KEY\n";
+        return false;
+    }
+
+    std::vector<std::string> headers = {
+        "Authorization: Bearer " + config_.api_key,
+        "Content-Type: application/json",
+        "Accept: application/json"
+    };
+
+    for (size_t start = 0; start < texts.size(); start += COHERE_MAX_BATCH) {
+        size_t end = std::min(texts.size(), start + COHERE_MAX_BATCH);
+        json payload = {
+            {"texts", std::vector<std::string>(texts.begin() + start, texts.begin() + end)},
+            {"model", config_.model},
+            {"input_type", config_.input_type}
+        };
+
+        std::string response;
+        long status = post_json(curl, config_.endpoint, payload.dump(), headers, 240L, response);
+        if (status != 200) {
+            std::cerr << "[Embedder] API request failed with status " << status << ": "
+                      << response.substr(0, 500) << "\n";
+            return false;
+        }
+
+        try {
+            json response_json = json::parse(response);
+            const json& batch = response_json.at("embeddings");
+            if (batch.size() != end - start) {
+                std::cerr << "[Embedder] Expected " << (end - start) << " embeddings, got " << batch.size() << "\n";
+                return false;
+            }
+            for (const auto& vector : batch) {
+                embeddings.push_back(vector.get<std::vector<float>>());
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "[Embedder] Unexpected API response: " << e.what() << "\n";
+            return false;
+        }
+    }
+
+    std::cout << "[Embedder] Generated " << embeddings.size() << " embeddings natively\n";
+    return true;
+}
+
+PythonEmbedder::PythonEmbedder(const std::string& work_dir) : work_dir_(work_dir) {}
+
+bool PythonEmbedder::embed(const std::vector<std::string>& texts,
+                           std::vector<std::vector<float>>& embeddings) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    embeddings.clear();
+    embeddings.reserve(texts.size());
+
+    std::error_code ec;
+    std::filesystem::create_directories(work_dir_, ec);
+
+    for (const auto& text : texts) {
+        std::string stem = (std::filesystem::path(work_dir_) / ("cv_" + std::to_string(counter_++))).string();
+        std::string text_file = stem + ".txt";
+        std::string output_file = stem + ".json";
+
+        {
+            std::ofstream file(text_file, std::ios::binary);
+            file << text;
+        }
+
+        // Filtering already happened in filter_cv_text
+#ifdef _WIN32
+        std::string cmd = "python ..\\src\\embedder.py --skip-filter --file \"" + text_file + "\" --output \"" + output_file + "\"";
+#else
+        std::string cmd = "python ../src/embedder.py --skip-filter --file \"" + text_file + "\" --output \"" + output_file + "\"";
+#endif
+        int result = std::system(cmd.c_str());
+        std::vector<float> embedding = result == 0 ? load_cv_embedding(output_file) : std::vector<float>();
+
+        std::filesystem::remove(text_file, ec);
+        std::filesystem::remove(output_file, ec);
+
+        if (embedding.empty()) {
+            std::cerr << "[Embedder] Python embedding script failed. Exit code: " << result << "\n";
+            return false;
+        }
+        embeddings.push_back(std::move(embedding));
+    }
+    return true;
+}
+
+std::unique_ptr<Embedder> make_embedder(const EmbedderConfig& config, const std::string& backend) {
+    std::string chosen = backend;
+    if (chosen.empty()) {
+        bool has_key = !config.api_key.empty() || std::getenv("COHERE_API_KEY") != nullptr;
+        chosen = has_key ? "native" : "python";
+    }
+
+    if (chosen == "native") {
+        return std::make_unique<CohereEmbedder>(config);
+    }
+    if (chosen == "python") {
+        return std::make_unique<PythonEmbedder>();
+    }
+    return nullptr;
+}
+
+std::string filter_cv_text(const std::string& raw_text, const EmbedderConfig& config) {
+    if (!config.filter_with_ollama || raw_text.empty()) {
+        return raw_text;
+    }
+
+    // Same prompt as filter_cv_with_ollama in embedder.py
+    std::string prompt =
+        "You are a professional CV parser. Extract and structure the following CV data for job matching:\n\n"
+        "1. Professional Summary\n"
+        "2. Work Experience (with correct company names, locations, dates)\n"
+        "3. Education (with correct institution names)\n"
+        "4. Skills (technical and soft skills)\n"
+        "5. Languages\n"
+        "6. Projects\n"
+        "7. Certifications\n\n"
+        "Format the output clearly with section headers. Keep all location names and dates exactly as they appear.\n"
+        "Omit personal interests, hobbies, references, and irrelevant details.\n"
+        "Return ONLY the structured CV data in txt format without ANY explanations, asterisks or additional commentary AT ALL.\n\n"
+        "CV Text:\n" + raw_text;
+
+    ensure_curl_initialized();
+    CURL* curl = curl_easy_init();
+    if (!curl) {
+        return raw_text;
+    }
+
+    json payload = {{"model", config.ollama_model}, {"prompt", prompt}, {"stream", false}};
+    std::string response;
+    std::cout << "[Filter] Calling Ollama with model: " << config.ollama_model << "\n";
+    long status = post_json(curl, config.ollama_url, payload.dump(),
+                            {"Content-Type: application/json"}, 240L, response);
+    curl_easy_cleanup(curl);
+
+    if (status != 200) {
+        std::cerr << "[Filter] Ollama unavailable (status " << status << "), using original text\n";
+        return raw_text;
+    }
+
+    try {
+        std::string filtered = json::parse(response).value("response", "");
+        size_t first = filtered.find_first_not_of(" \t\r\n");
+        size_t last = filtered.find_last_not_of(" \t\r\n");
+        if (first == std::string::npos) {
+            return raw_text;
+        }
+        filtered = filtered.substr(first, last - first + 1);
+        std::cout << "[Filter] Filtering complete. Output length: " << filtered.size() << " characters.\n";
+        return filtered;
+    } catch (const std::exception& e) {
+        std::cerr << "[Filter] Unexpected Ollama response: " << e.what() << ", using original text\n";
+        return raw_text;
+    }
+}
+
+std::vector<std::string> cv_section_texts(const std::string& text, const EmbedderConfig& config) {
+    std::vector<std::string> texts{text};
+    if (!config.split_sections) {
+        return texts;
+    }
+
+    std::vector<std::string> sections;
+    std::string section;
+    size_t words = 0;
+    auto flush = [&] {
+        if (words > 0) {
+            sections.push_back(section);
+        }
+        section.clear();
+        words = 0;
+    };
+
+    // Paragraphs join the open section while it has room; an overlong
+    // paragraph is cut at word boundaries
+    std::istringstream lines(text);
+    std::string line;
+    std::string paragraph;
+    size_t paragraph_words = 0;
+    auto end_paragraph = [&] {
+        if (paragraph_words == 0) {
+            return;
+        }
+        if (words > 0 && words + paragraph_words > CV_SECTION_WORDS) {
+            flush();
+        }
+        std::istringstream tokens(paragraph);
+        std::string word;
+        while (tokens >> word) {
+            if (words == CV_SECTION_WORDS) {
+                flush();
+            }
+            section += (section.empty() ? "" : " ") + word;
+            words++;
+        }
+        paragraph.clear();
+        paragraph_words = 0;
+    };
+    while (std::getline(lines, line)) {
+        std::istringstream tokens(line);
+        std::string word;
+        size_t line_words = 0;
+        while (tokens >> word) {
+            line_words++;
+        }
+        if (line_words == 0) {
+            end_paragraph();
+            continue;
+        }
+        paragraph += line + "\n";
+        paragraph_words += line_words;
+    }
+    end_paragraph();
+    flush();
+
+    if (sections.size() > 1) {
+        texts.insert(texts.end(), sections.begin(), sections.end());
+    }
+    return texts;
+}
+
+bool embed_cv_file(Embedder& embedder, const EmbedderConfig& config,
+                   const std::string& cv_file, std::vector<float>& embedding,
+                   std::string* cv_text, size_t* sections) {
+    std::ifstream file(cv_file, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[Embedder] Failed to open file " << cv_file << "\n";
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    std::string text = filter_cv_text(buffer.str(), config);
+    if (text.empty()) {
+        std::cerr << "[Embedder] No text provided for embedding generation\n";
+        return false;
+    }
+
+    std::vector<std::string> texts = sections ? cv_section_texts(text, config) : std::vector<std::string>{text};
+    std::vector<std::vector<float>> embeddings;
+    if (!embedder.embed(texts, embeddings) || embeddings.size() != texts.size()) {
+        return false;
+    }
+    embedding = std::move(embeddings.front());
+    for (size_t i = 1; i < embeddings.size(); i++) {
+        embedding.insert(embedding.end(), embeddings[i].begin(), embeddings[i].end());
+    }
+    if (sections) {
+        *sections = embeddings.size();
+    }
+    if (cv_text) {
+        *cv_text = std::move(text);
+    }
+    return true;
+}
+
+bool save_cv_embedding(const std::vector<float>& embedding, const std::string& output_path, size_t sections) {
+    try {
+        std::filesystem::path parent = std::filesystem::path(output_path).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent);
+        }
+        std::ofstream file(output_path);
+        if (!file.is_open()) {
+            std::cerr << "[Embedder] Cannot write embedding to " << output_path << "\n";
+            return false;
+        }
+        if (sections > 1) {
+            size_t width = embedding.size() / sections;
+            json rows = json::array();
+            for (size_t row = 0; row < sections; row++) {
+                rows.push_back(std::vector<float>(embedding.begin() + row * width,
+                                                  embedding.begin() + (row + 1) * width));
+            }
+            file << rows.dump();
+            return true;
+        }
+        file << json(embedding).dump();
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "[Embedder] Error saving embedding: " << e.what() << "\n";
+        return false;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Settings shared by the embedding backends. The defaults match embedder.py,
+// which is how the job vectors in the database were produced.
+struct EmbedderConfig {
+    std::string api_key;                        // Empty: read COHERE_API_KEY
+    std::string model = "embed-english-v3.0";
+    std::string input_type = "search_document";
+    std::string endpoint = "https://api.cohere.ai/v1/embed";
+    bool filter_with_ollama = true;             // Structure CV text with a local LLM first
+    bool split_sections = false;                // Also embed each CV section, for max-sim matching
+    std::string ollama_model = "gemma3:4b";
+    std::string ollama_url = "http://localhost:11434/api/generate";
+};
+
+// Turns texts into embedding vectors
+class Embedder {
+public:
+    virtual ~Embedder() = default;
+
+    // Embed every text, in order. Returns false (and logs) on failure.
+    virtual bool embed(const std::vector<std::string>& texts,
+                       std::vector<std::vector<float>>& embeddings) = 0;
+
+    virtual const char* name() const = 0;
+};
+
+// Calls the Cohere embed API directly through libcurl, batching up to the
+// API's per-request limit and keeping one connection alive across calls
+class CohereEmbedder : public Embedder {
+public:
+    explicit CohereEmbedder(const EmbedderConfig& config);
+    ~CohereEmbedder() override;
+
+    bool embed(const std::vector<std::string>& texts,
+               std::vector<std::vector<float>>& embeddings) override;
+    const char* name() const override { return "native"; }
+
+private:
+    EmbedderConfig config_;
+    void* curl_ = nullptr; // CURL*, serialised by mutex_
+    std::mutex mutex_;
+};
+
+// Fallback that runs embedder.py once per text
+class PythonEmbedder : public Embedder {
+public:
+    explicit PythonEmbedder(const std::string& work_dir = "../output/embed");
+
+    bool embed(const std::vector<std::string>& texts,
+               std::vector<std::vector<float>>& embeddings) override;
+    const char* name() const override { return "python"; }
+
+private:
+    std::string work_dir_;
+    std::mutex mutex_;
+    size_t counter_ = 0;
+};
+
+// "native" when an API key is configured, otherwise the Python fallback.
+// An explicit backend name ("native" or "python") overrides the choice;
+// returns nullptr for unknown names.
+std::unique_ptr<Embedder> make_embedder(const EmbedderConfig& config, const std::string& backend = "");
+
+// Restructure raw CV text with Ollama the way embedder.py does; returns the
+// original text if Ollama is unavailable
+std::string filter_cv_text(const std::string& raw_text, const EmbedderConfig& config);
+
+// The texts a CV is embedded as: the whole text first, then, with
+// config.split_sections and more than one section, each section of it.
+// Sections are runs of blank-line separated paragraphs of up to about
+// CV_SECTION_WORDS words, so one long CV is not diluted into a single vector.
+const size_t CV_SECTION_WORDS = 150;
+std::vector<std::string> cv_section_texts(const std::string& text, const EmbedderConfig& config);
+
+// Read a CV text file, optionally filter it, and embed it. cv_text, if
+// given, receives the text that was embedded. With sections given and
+// config.split_sections, embedding receives one row per text of
+// cv_section_texts, back to back, and *sections their count.
+bool embed_cv_file(Embedder& embedder, const EmbedderConfig& config,
+                   const std::string& cv_file, std::vector<float>& embedding,
+                   std::string* cv_text = nullptr, size_t* sections = nullptr);
+
+// Write an embedding as the flat JSON array embedder.py produces, or a
+// multi-vector embedding of several rows as an array of arrays
+bool save_cv_embedding(const std::vector<float>& embedding, const std::string& output_path,
+                       size_t sections = 1);
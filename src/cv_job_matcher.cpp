@@ -1,136 +1,376 @@
 #include "cv_job_matcher.hpp"
+#include "match_engine.hpp"
+#include "cv_embedder.hpp"
 #include <iostream>
 #include <fstream>
 #include <string>
-#include <cstdlib>
 #include <vector>
+#include <cstdlib>
+#include <filesystem>
+#include <algorithm>
+#include <chrono>
+#include <sstream>
 #include <nlohmann/json.hpp>
-#include <sqlite3.h>
 
 using json = nlohmann::json;
 
-struct Job {
-    int id;
-    std::string title;
-    std::string description;
-    std::string location;
-    std::string source;
-    std::vector<std::string> skills;
-    float similarity;
+void to_json(json& j, const Job& job) {
+    j = json{
+        {"id", job.id},
+        {"title", job.title},
+        {"description", job.description},
+        {"location", job.location},
+        {"source", job.source},
+        {"skills", job.skills},
+        {"similarity", job.similarity},
+        {"embedding_similarity", job.embedding_similarity},
+        {"keyword_relevance", job.keyword_relevance}
+    };
+}
+
+// SAX handler accepting one flat array of numbers or, when sections are
+// allowed, an array of equal-length number arrays appended row after row
+class EmbeddingReader : public nlohmann::json_sax<json> {
+public:
+    EmbeddingReader(std::vector<float>& values, bool allow_sections)
+        : values_(values), allow_sections_(allow_sections) {}
+
+    bool number_integer(number_integer_t value) override { return push(static_cast<float>(value)); }
+    bool number_unsigned(number_unsigned_t value) override { return push(static_cast<float>(value)); }
+    bool number_float(number_float_t value, const string_t&) override { return push(static_cast<float>(value)); }
+
+    bool start_array(std::size_t) override {
+        if (depth_ == 0 || (depth_ == 1 && allow_sections_ && !flat_)) {
+            depth_++;
+            row_start_ = values_.size();
+            return true;
+        }
+        return fail("nested array");
+    }
+    bool end_array() override {
+        if (depth_-- == 2) {
+            size_t width = values_.size() - row_start_;
+            if (width == 0 || (sections_ > 0 && width != width_)) {
+                return fail("section length");
+            }
+            width_ = width;
+            sections_++;
+        }
+        return true;
+    }
+
+    bool null() override { return fail("null"); }
+    bool boolean(bool) override { return fail("boolean"); }
+    bool string(string_t&) override { return fail("string"); }
+    bool binary(binary_t&) override { return fail("binary"); }
+    bool start_object(std::size_t) override { return fail("object"); }
+    bool key(string_t&) override { return fail("object"); }
+    bool end_object() override { return fail("object"); }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception& e) override {
+        error_ = e.what();
+        return false;
+    }
+
+    const std::string& error() const { return error_; }
+    // Rows read: 1 for a flat array, otherwise the number of sections
+    size_t sections() const { return flat_ ? 1 : sections_; }
+
+private:
+    bool push(float value) {
+        if (depth_ == 0 || (depth_ == 1 && sections_ > 0)) {
+            return fail("number outside the array");
+        }
+        flat_ = flat_ || depth_ == 1;
+        values_.push_back(value);
+        return true;
+    }
+
+    bool fail(const char* what) {
+        error_ = std::string("unexpected ") + what;
+        return false;
+    }
+
+    std::vector<float>& values_;
+    bool allow_sections_;
+    bool flat_ = false;
+    int depth_ = 0;
+    size_t row_start_ = 0;
+    size_t width_ = 0;
+    size_t sections_ = 0;
+    std::string error_;
 };
 
-void match_cv_with_jobs(const std::string& cv_embedding_path, 
+std::vector<float> load_cv_embedding(const std::string& cv_embedding_path, size_t dimension_hint,
+                                     size_t* sections) {
+    std::vector<float> embedding;
+    std::ifstream file(cv_embedding_path, std::ios::binary);
+    if (!file.is_open()) {
+        std::cerr << "[CV Job Matcher] Failed to open CV embedding file: " << cv_embedding_path << "\n";
+        return embedding;
+    }
+
+    embedding.reserve(dimension_hint);
+    EmbeddingReader reader(embedding, sections != nullptr);
+    if (!json::sax_parse(file, &reader)) {
+        std::cerr << "[CV Job Matcher] Error parsing CV embedding: " << reader.error() << "\n";
+        embedding.clear();
+    }
+    if (sections) {
+        *sections = embedding.empty() ? 0 : reader.sections();
+    }
+    return embedding;
+}
+
+bool save_matches_to_json(const std::vector<Job>& matches, const std::string& output_path) {
+    try {
+        std::filesystem::path parent = std::filesystem::path(output_path).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent);
+        }
+
+        json matches_json = matches;
+
+        std::ofstream file(output_path);
+        if (!file.is_open()) {
+            std::cerr << "[CV Job Matcher] Failed to open matches output file\n";
+            return false;
+        }
+        file << matches_json.dump(2);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "[CV Job Matcher] Error saving matches: " << e.what() << "\n";
+        return false;
+    }
+}
+
+void print_matches(const std::vector<Job>& matches) {
+    // Display results to user
+    std::cout << "\n============= Top " << matches.size() << " Job Matches =============\n\n";
+
+    for (size_t i = 0; i < matches.size(); i++) {
+        const auto& job = matches[i];
+
+        std::cout << "Match #" << (i + 1) << " (Similarity: " << job.similarity << ")\n";
+        std::cout << "Title: " << job.title << "\n";
+        std::cout << "Location: " << job.location << "\n";
+        std::cout << "Source: " << job.source << "\n";
+
+        std::cout << "Skills: ";
+        for (size_t j = 0; j < std::min(job.skills.size(), size_t(5)); j++) {
+            std::cout << job.skills[j];
+            if (j < std::min(job.skills.size(), size_t(5)) - 1) {
+                std::cout << ", ";
+            }
+        }
+
+        if (job.skills.size() > 5) {
+            std::cout << " (+" << (job.skills.size() - 5) << " more)";
+        }
+
+        std::cout << "\n\n";
+        std::cout << "Description Preview: \n";
+
+        // Show a preview of the description
+        if (job.description.length() > DESCRIPTION_PREVIEW_CHARS) {
+            std::cout << job.description.substr(0, DESCRIPTION_PREVIEW_CHARS) << "...\n";
+        } else {
+            std::cout << job.description << "\n";
+        }
+
+        std::cout << "---------------------------------------------\n\n";
+    }
+
+    if (matches.empty()) {
+        std::cout << "No matching jobs found.\n";
+    }
+}
+
+void match_cv_with_jobs(const std::string& cv_embedding_path,
                         const std::string& db_path,
                         const std::string& faiss_index_path,
                         int top_k) {
+    std::cout << "[CV Job Matcher] Using database: " << db_path << "\n";
+
+    EngineConfig config;
+    config.db_path = db_path;
+    config.faiss_index_path = faiss_index_path;
+
+    MatchEngine engine(config);
+    if (!engine.load()) {
+        std::cerr << "[CV Job Matcher] Failed to load job index\n";
+        return;
+    }
+    MatchOptions options;
+    options.top_k = top_k;
+    match_cv_with_jobs(cv_embedding_path, engine, options);
+}
+
+void match_cv_with_jobs(const std::string& cv_embedding_path,
+                        const MatchEngine& engine,
+                        const MatchOptions& options,
+                        const std::string& cv_text) {
     std::cout << "[CV Job Matcher] Starting CV-Job matching process...\n";
     std::cout << "[CV Job Matcher] Using CV embedding from: " << cv_embedding_path << "\n";
-    std::cout << "[CV Job Matcher] Using database: " << db_path << "\n";
-    
+
     // Define output path for matches
     std::string matches_output_path = "../output/matches.json";
-    
-    // Call the Python script for matching
-#ifdef _WIN32
-    std::string cmd = "python ..\\src\\job_matcher.py "
-                      "--cv-embedding \"" + cv_embedding_path + "\" "
-                      "--db-path \"" + db_path + "\" "
-                      "--output \"" + matches_output_path + "\" "
-                      "--top-k " + std::to_string(top_k);
-#else
-    std::string cmd = "python ../src/job_matcher.py "
-                      "--cv-embedding \"" + cv_embedding_path + "\" "
-                      "--db-path \"" + db_path + "\" "
-                      "--output \"" + matches_output_path + "\" "
-                      "--top-k " + std::to_string(top_k);
-#endif
-
-    std::cout << "[CV Job Matcher] Executing command: " << cmd << "\n";
-    int result = std::system(cmd.c_str());
-    
-    if (result != 0) {
-        std::cerr << "[CV Job Matcher] Python job matching script failed with exit code: " << result << "\n";
+
+    size_t sections = 0;
+    std::vector<float> cv_embedding = load_cv_embedding(cv_embedding_path, engine.dimension(), &sections);
+    if (cv_embedding.empty()) {
         return;
     }
-    
-    // Load and display results
-    try {
-        std::cout << "\n[CV Job Matcher] Loading matching results from " << matches_output_path << "\n";
-        std::ifstream file(matches_output_path);
-        
-        if (!file.is_open()) {
-            std::cerr << "[CV Job Matcher] Failed to open matches output file\n";
-            return;
-        }
-        
-        json matches_json;
-        file >> matches_json;
-        file.close();
-        
-        // Parse jobs from JSON
-        std::vector<Job> matches;
-        for (const auto& job_json : matches_json) {
-            Job job;
-            job.id = job_json["id"];
-            job.title = job_json["title"];
-            job.description = job_json["description"];
-            job.location = job_json["location"];
-            job.source = job_json["source"];
-            job.similarity = job_json["similarity"];
-            
-            // Parse skills array
-            if (job_json.contains("skills") && job_json["skills"].is_array()) {
-                for (const auto& skill : job_json["skills"]) {
-                    job.skills.push_back(skill);
-                }
-            }
-            
-            matches.push_back(job);
-        }
-        
-        // Display results to user
-        std::cout << "\n============= Top " << matches.size() << " Job Matches =============\n\n";
-        
-        for (size_t i = 0; i < matches.size(); i++) {
-            const auto& job = matches[i];
-            
-            std::cout << "Match #" << (i + 1) << " (Similarity: " << job.similarity << ")\n";
-            std::cout << "Title: " << job.title << "\n";
-            std::cout << "Location: " << job.location << "\n";
-            std::cout << "Source: " << job.source << "\n";
-            
-            std::cout << "Skills: ";
-            for (size_t j = 0; j < std::min(job.skills.size(), size_t(5)); j++) {
-                std::cout << job.skills[j];
-                if (j < std::min(job.skills.size(), size_t(5)) - 1) {
-                    std::cout << ", ";
-                }
-            }
-            
-            if (job.skills.size() > 5) {
-                std::cout << " (+" << (job.skills.size() - 5) << " more)";
+    if (sections > 1) {
+        std::cout << "[CV Job Matcher] Multi-vector CV with " << sections << " sections\n";
+    }
+
+    std::vector<Job> matches = engine.match(cv_embedding, options, cv_text, sections);
+
+    // Keep writing the matches file for consumers of the previous Python output
+    save_matches_to_json(matches, matches_output_path);
+    print_matches(matches);
+
+    std::cout << "[CV Job Matcher] Job matching process completed.\n";
+}
+
+// Resolve the embedding files named by a --cv-batch directory or manifest
+static std::vector<std::string> list_batch_embeddings(const std::string& batch_path) {
+    namespace fs = std::filesystem;
+    std::vector<std::string> paths;
+
+    if (fs::is_directory(batch_path)) {
+        for (const auto& entry : fs::directory_iterator(batch_path)) {
+            std::string extension = entry.path().extension().string();
+            if (entry.is_regular_file() && (extension == ".json" || extension == ".txt")) {
+                paths.push_back(entry.path().string());
             }
-            
-            std::cout << "\n\n";
-            std::cout << "Description Preview: \n";
-            
-            // Show a preview of the description (first 200 chars)
-            if (job.description.length() > 200) {
-                std::cout << job.description.substr(0, 200) << "...\n";
-            } else {
-                std::cout << job.description << "\n";
+        }
+        std::sort(paths.begin(), paths.end());
+        return paths;
+    }
+
+    std::ifstream manifest(batch_path);
+    if (!manifest.is_open()) {
+        std::cerr << "[CV Job Matcher] Failed to open CV batch manifest: " << batch_path << "\n";
+        return paths;
+    }
+
+    fs::path base = fs::path(batch_path).parent_path();
+    std::string line;
+    while (std::getline(manifest, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        fs::path entry(line);
+        paths.push_back(entry.is_absolute() ? entry.string() : (base / entry).string());
+    }
+    return paths;
+}
+
+void match_cv_batch(const std::string& batch_path,
+                    const MatchEngine& engine,
+                    const MatchOptions& options,
+                    const std::string& output_path,
+                    Embedder* embedder,
+                    const EmbedderConfig* embedder_config) {
+    std::cout << "[CV Job Matcher] Starting batch matching from: " << batch_path << "\n";
+
+    std::vector<std::string> paths = list_batch_embeddings(batch_path);
+    if (paths.empty()) {
+        std::cerr << "[CV Job Matcher] No CV embeddings found in " << batch_path << "\n";
+        return;
+    }
+
+    // Pack every usable CV into one contiguous query matrix
+    std::vector<float> queries;
+    queries.reserve(paths.size() * engine.dimension());
+    std::vector<std::string> matched_paths;
+    std::vector<std::string> matched_texts;
+    std::vector<size_t> matched_sections;
+    json output = json::array();
+
+    // Embed all text CVs (and their sections, when split) in one batched
+    // call rather than one request per CV
+    std::vector<std::string> texts;
+    std::vector<std::string> embed_texts;
+    std::vector<int> text_slot(paths.size(), -1);
+    std::vector<size_t> first_text;
+    for (size_t i = 0; i < paths.size(); i++) {
+        if (std::filesystem::path(paths[i]).extension() == ".txt") {
+            std::ifstream file(paths[i], std::ios::binary);
+            std::stringstream buffer;
+            buffer << file.rdbuf();
+            text_slot[i] = static_cast<int>(texts.size());
+            texts.push_back(embedder_config ? filter_cv_text(buffer.str(), *embedder_config) : buffer.str());
+            std::vector<std::string> parts = embedder_config ? cv_section_texts(texts.back(), *embedder_config)
+                                                             : std::vector<std::string>{texts.back()};
+            first_text.push_back(embed_texts.size());
+            embed_texts.insert(embed_texts.end(), parts.begin(), parts.end());
+        }
+    }
+    first_text.push_back(embed_texts.size());
+
+    std::vector<std::vector<float>> text_embeddings;
+    if (!embed_texts.empty()) {
+        if (!embedder || !embedder->embed(embed_texts, text_embeddings) ||
+            text_embeddings.size() != embed_texts.size()) {
+            std::cerr << "[CV Job Matcher] Could not embed " << texts.size() << " text CVs\n";
+            text_embeddings.clear();
+        }
+    }
+
+    for (size_t i = 0; i < paths.size(); i++) {
+        const std::string& path = paths[i];
+        std::vector<float> embedding;
+        size_t sections = 1;
+        if (text_slot[i] < 0) {
+            embedding = load_cv_embedding(path, engine.dimension(), &sections);
+        } else if (!text_embeddings.empty()) {
+            size_t slot = static_cast<size_t>(text_slot[i]);
+            sections = first_text[slot + 1] - first_text[slot];
+            for (size_t t = first_text[slot]; t < first_text[slot + 1]; t++) {
+                embedding.insert(embedding.end(), text_embeddings[t].begin(), text_embeddings[t].end());
             }
-            
-            std::cout << "---------------------------------------------\n\n";
         }
-        
-        if (matches.empty()) {
-            std::cout << "No matching jobs found.\n";
+
+        if (embedding.empty() || embedding.size() != sections * engine.dimension()) {
+            std::cerr << "[CV Job Matcher] Skipping " << path << ": expected dimension "
+                      << engine.dimension() << ", got " << (sections ? embedding.size() / sections : 0) << "\n";
+            output.push_back({{"cv_embedding", path}, {"error", "unusable embedding"}});
+            continue;
+        }
+        queries.insert(queries.end(), embedding.begin(), embedding.end());
+        matched_paths.push_back(path);
+        matched_texts.push_back(text_slot[i] < 0 ? std::string() : texts[text_slot[i]]);
+        matched_sections.push_back(sections);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::vector<Job>> results =
+        engine.match_batch(queries, matched_paths.size(), options, &matched_texts, &matched_sections);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    for (size_t i = 0; i < matched_paths.size(); i++) {
+        output.push_back({{"cv_embedding", matched_paths[i]}, {"matches", results[i]}});
+    }
+
+    try {
+        std::filesystem::path parent = std::filesystem::path(output_path).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent);
         }
-        
+        std::ofstream file(output_path);
+        file << output.dump(2);
     } catch (const std::exception& e) {
-        std::cerr << "[CV Job Matcher] Error parsing matches: " << e.what() << "\n";
+        std::cerr << "[CV Job Matcher] Error saving batch matches: " << e.what() << "\n";
+        return;
     }
-    
-    std::cout << "[CV Job Matcher] Job matching process completed.\n";
-}
\ No newline at end of file
+
+    std::cout << "[CV Job Matcher] Matched " << matched_paths.size() << " of " << paths.size()
+              << " CVs in " << elapsed.count() << " ms; results written to " << output_path << "\n";
+}
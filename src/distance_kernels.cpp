@@ -0,0 +1,230 @@
+#include "distance_kernels.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DISTANCE_KERNELS_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+// GCC and Clang only emit AVX instructions inside functions that opt in;
+// MSVC accepts the intrinsics anywhere.
+#if defined(__GNUC__) || defined(__clang__)
+#define TARGET_AVX2 __attribute__((target("avx2,fma")))
+#define TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define TARGET_AVX2
+#define TARGET_AVX512
+#endif
+
+using DotFn = float (*)(const float*, const float*, size_t);
+using DotInt8Fn = float (*)(const float*, const int8_t*, size_t);
+
+static float dot_scalar(const float* a, const float* b, size_t d) {
+    float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+    size_t i = 0;
+    for (; i + 4 <= d; i += 4) {
+        sum0 += a[i] * b[i];
+        sum1 += a[i + 1] * b[i + 1];
+        sum2 += a[i + 2] * b[i + 2];
+        sum3 += a[i + 3] * b[i + 3];
+    }
+    for (; i < d; i++) {
+        sum0 += a[i] * b[i];
+    }
+    return (sum0 + sum1) + (sum2 + sum3);
+}
+
+static float dot_int8_scalar(const float* a, const int8_t* codes, size_t d) {
+    float sum0 = 0.0f, sum1 = 0.0f, sum2 = 0.0f, sum3 = 0.0f;
+    size_t i = 0;
+    for (; i + 4 <= d; i += 4) {
+        sum0 += a[i] * codes[i];
+        sum1 += a[i + 1] * codes[i + 1];
+        sum2 += a[i + 2] * codes[i + 2];
+        sum3 += a[i + 3] * codes[i + 3];
+    }
+    for (; i < d; i++) {
+        sum0 += a[i] * codes[i];
+    }
+    return (sum0 + sum1) + (sum2 + sum3);
+}
+
+#ifdef DISTANCE_KERNELS_X86
+
+TARGET_AVX2 static float dot_avx2(const float* a, const float* b, size_t d) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= d; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    for (; i + 8 <= d; i += 8) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    }
+
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    float result = _mm_cvtss_f32(sum);
+
+    for (; i < d; i++) {
+        result += a[i] * b[i];
+    }
+    return result;
+}
+
+TARGET_AVX512 static float dot_avx512(const float* a, const float* b, size_t d) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= d; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), _mm512_loadu_ps(b + i + 16), acc1);
+    }
+    for (; i + 16 <= d; i += 16) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc0);
+    }
+    if (i < d) {
+        __mmask16 mask = static_cast<__mmask16>((1u << (d - i)) - 1);
+        acc1 = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(mask, a + i), _mm512_maskz_loadu_ps(mask, b + i), acc1);
+    }
+
+    // Spill and add the lanes: the 512-bit reduce/shuffle intrinsics trip a
+    // spurious -Wuninitialized in GCC 12's headers
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, _mm512_add_ps(acc0, acc1));
+    float result = 0.0f;
+    for (float lane : lanes) {
+        result += lane;
+    }
+    return result;
+}
+
+TARGET_AVX2 static float dot_int8_avx2(const float* a, const int8_t* codes, size_t d) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= d; i += 16) {
+        __m128i packed = _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes + i));
+        __m256 lo = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(packed));
+        __m256 hi = _mm256_cvtepi32_ps(_mm256_cvtepi8_epi32(_mm_srli_si128(packed, 8)));
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), lo, acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), hi, acc1);
+    }
+
+    __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 0x55));
+    float result = _mm_cvtss_f32(sum);
+
+    for (; i < d; i++) {
+        result += a[i] * codes[i];
+    }
+    return result;
+}
+
+// Sign-extend 16 codes to floats. The zero-masked conversions avoid the
+// same GCC 12 -Wuninitialized false positive as the reductions below.
+TARGET_AVX512 static inline __m512 widen_int8_avx512(const int8_t* codes) {
+    __m512i widened = _mm512_maskz_cvtepi8_epi32(0xFFFF, _mm_loadu_si128(reinterpret_cast<const __m128i*>(codes)));
+    return _mm512_maskz_cvtepi32_ps(0xFFFF, widened);
+}
+
+TARGET_AVX512 static float dot_int8_avx512(const float* a, const int8_t* codes, size_t d) {
+    __m512 acc0 = _mm512_setzero_ps();
+    __m512 acc1 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 32 <= d; i += 32) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), widen_int8_avx512(codes + i), acc0);
+        acc1 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i + 16), widen_int8_avx512(codes + i + 16), acc1);
+    }
+    for (; i + 16 <= d; i += 16) {
+        acc0 = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), widen_int8_avx512(codes + i), acc0);
+    }
+
+    alignas(64) float lanes[16];
+    _mm512_store_ps(lanes, _mm512_add_ps(acc0, acc1));
+    float result = 0.0f;
+    for (float lane : lanes) {
+        result += lane;
+    }
+    for (; i < d; i++) {
+        result += a[i] * codes[i];
+    }
+    return result;
+}
+
+static bool cpu_has_avx2() {
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool fma = (info[2] & (1 << 12)) != 0;
+    if (!osxsave || !fma || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+#endif
+}
+
+static bool cpu_has_avx512f() {
+#ifdef _MSC_VER
+    if (!cpu_has_avx2() || (_xgetbv(0) & 0xe6) != 0xe6) {
+        return false;
+    }
+    int info[4];
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 16)) != 0;
+#else
+    return __builtin_cpu_supports("avx512f");
+#endif
+}
+
+#endif // DISTANCE_KERNELS_X86
+
+struct DotKernel {
+    DotFn fn;
+    DotInt8Fn int8_fn;
+    const char* isa;
+};
+
+static DotKernel select_kernel() {
+#ifdef DISTANCE_KERNELS_X86
+    if (cpu_has_avx512f()) {
+        return {dot_avx512, dot_int8_avx512, "avx512"};
+    }
+    if (cpu_has_avx2()) {
+        return {dot_avx2, dot_int8_avx2, "avx2"};
+    }
+#endif
+    return {dot_scalar, dot_int8_scalar, "scalar"};
+}
+
+static const DotKernel& kernel() {
+    static const DotKernel selected = select_kernel();
+    return selected;
+}
+
+float dot_product(const float* a, const float* b, size_t d) {
+    return kernel().fn(a, b, d);
+}
+
+float dot_product_int8(const float* a, const int8_t* codes, size_t d) {
+    return kernel().int8_fn(a, codes, d);
+}
+
+const char* dot_product_isa() {
+    return kernel().isa;
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Inner product of two float vectors of length d, using the widest SIMD
+// instruction set the CPU supports (AVX-512F, AVX2+FMA or scalar). The
+// implementation is selected once, on first use.
+float dot_product(const float* a, const float* b, size_t d);
+
+// Inner product of a float query with int8 codes, widened on the fly, for
+// asymmetric distance against scalar-quantised rows. Same dispatch as
+// dot_product.
+float dot_product_int8(const float* a, const int8_t* codes, size_t d);
+
+// Name of the kernels dot_product and dot_product_int8 dispatch to ("avx512", "avx2" or "scalar")
+const char* dot_product_isa();
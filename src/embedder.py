@@ -428,13 +428,67 @@ def format_job_for_embedding(job_data: Dict[str, Any]) -> str:
     return formatted_text
 
 
-def save_job_to_database(job_data: Dict[str, Any], embedding: List[float], db_path: str) -> None:
+def format_job_chunks(job_data: Dict[str, Any], chunk_words: int = 0) -> List[str]:
+    """
+    Format job data into one text per description chunk, so long postings
+    are not truncated by the embedding model.
+    
+    Args:
+        job_data: Dictionary containing job details
+        chunk_words: Description words per chunk; 0 keeps the whole job in one text
+        
+    Returns:
+        The formatted texts; a single text unless the description is longer than chunk_words
+    """
+    words = job_data.get("description", "").split()
+    if chunk_words <= 0 or len(words) <= chunk_words:
+        return [format_job_for_embedding(job_data)]
+    
+    # Every chunk repeats the title, skills and location around its slice of the description
+    chunks = []
+    for start in range(0, len(words), chunk_words):
+        chunk_job = dict(job_data)
+        chunk_job["description"] = " ".join(words[start:start + chunk_words])
+        chunks.append(format_job_for_embedding(chunk_job))
+    print(f"[Embedder] Split job description into {len(chunks)} chunks of up to {chunk_words} words")
+    return chunks
+
+
+def embed_job(embedder: "Embedder", job_data: Dict[str, Any], chunk_words: int = 0) -> Union[List[float], List[List[float]]]:
+    """
+    Generate the embedding of a job: one vector, or one per description chunk
+    for a job longer than chunk_words words. The matcher scores a chunked job
+    by its best-matching chunk.
+    
+    Args:
+        embedder: Embedder instance
+        job_data: Dictionary containing job details
+        chunk_words: Description words per chunk; 0 disables chunking
+        
+    Returns:
+        An embedding vector, or a list of chunk embedding vectors
+    """
+    chunks = format_job_chunks(job_data, chunk_words)
+    if len(chunks) == 1:
+        embedding = embedder.generate_embedding(chunks[0])
+        print(f"\n[Embedder] Job embedding generated successfully!")
+        print(f"Embedding size: {len(embedding)} dimensions")
+        print(f"First 10 dimensions: {', '.join(map(str, embedding[:10]))}")
+        return embedding
+    
+    embeddings = embedder.generate_embeddings_batch(chunks)
+    print(f"\n[Embedder] Job embeddings generated successfully!")
+    print(f"Chunks: {len(embeddings)}, embedding size: {len(embeddings[0])} dimensions")
+    return embeddings
+
+
+def save_job_to_database(job_data: Dict[str, Any], embedding: Union[List[float], List[List[float]]], db_path: str) -> None:
     """
     Save job details along with its embedding to a SQLite database.
     
     Args:
         job_data: Dictionary containing job details
-        embedding: The embedding vector for the job
+        embedding: The embedding vector for the job, or a list of chunk vectors
         db_path: Path to SQLite database
     """
     try:
@@ -519,6 +573,7 @@ def main():
     parser.add_argument("--db-path", type=str, help="Path to SQLite database for storing jobs with embeddings")
     parser.add_argument("--skip-skills-extraction", action="store_true", help="Skip skills extraction from job description")
     parser.add_argument("--gemma-model", type=str, default="gemma3:4b", help="Gemma model to use for text processing")
+    parser.add_argument("--chunk-words", type=int, default=0, help="Embed job descriptions longer than this many words as several chunks (0 disables)")
     
     args = parser.parse_args()
     
@@ -678,16 +733,8 @@ def process_single_job(args, embedder, default_db_path):
                     print("[Embedder] Skills extraction skipped, using empty skills list")
                     job["skills"] = []
                 
-                # Format job data for embedding
-                formatted_job = format_job_for_embedding(job)
-                
-                # Generate embedding
-                embedding = embedder.generate_embedding(formatted_job)
-                
-                # Print some info about the embedding
-                print(f"\n[Embedder] Job embedding generated successfully!")
-                print(f"Embedding size: {len(embedding)} dimensions")
-                print(f"First 10 dimensions: {', '.join(map(str, embedding[:10]))}")
+                # Generate embedding, chunked for long descriptions
+                embedding = embed_job(embedder, job, args.chunk_words)
                 
                 # Determine database path
                 db_path = args.db_path if args.db_path else default_db_path
@@ -711,16 +758,8 @@ def process_single_job(args, embedder, default_db_path):
                 print("[Embedder] Skills extraction skipped, using empty skills list")
                 job_data["skills"] = []
             
-            # Format job data for embedding
-            formatted_job = format_job_for_embedding(job_data)
-            
-            # Generate embedding
-            embedding = embedder.generate_embedding(formatted_job)
-            
-            # Print some info about the embedding
-            print(f"\n[Embedder] Job embedding generated successfully!")
-            print(f"Embedding size: {len(embedding)} dimensions")
-            print(f"First 10 dimensions: {', '.join(map(str, embedding[:10]))}")
+            # Generate embedding, chunked for long descriptions
+            embedding = embed_job(embedder, job_data, args.chunk_words)
             
             # Determine database path
             db_path = args.db_path if args.db_path else default_db_path
@@ -782,11 +821,8 @@ def process_job_directory(args, embedder, default_job_dir, default_db_path):
                         print("[Embedder] Skills extraction skipped, using empty skills list")
                         job_data["skills"] = []
                     
-                    # Format job data for embedding
-                    formatted_job = format_job_for_embedding(job_data)
-                    
-                    # Generate embedding
-                    embedding = embedder.generate_embedding(formatted_job)
+                    # Generate embedding, chunked for long descriptions
+                    embedding = embed_job(embedder, job_data, args.chunk_words)
                     
                     # Save job with embedding to database
                     save_job_to_database(job_data, embedding, db_path)
@@ -0,0 +1,207 @@
+#include "embedding_store.hpp"
+#include "distance_kernels.hpp"
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const char STORE_MAGIC[8] = {'A', 'J', 'M', 'E', 'M', 'B', '\0', '\0'};
+
+static uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool write_embedding_store(const std::string& path, const std::vector<int64_t>& ids,
+                           const std::vector<float>& vectors, int dimension,
+                           int64_t source_count, int64_t source_max_id) {
+    size_t count = ids.size();
+    size_t stride = padded_row_stride(dimension);
+
+    EmbeddingStoreHeader header{};
+    std::memcpy(header.magic, STORE_MAGIC, sizeof(STORE_MAGIC));
+    header.version = EMBEDDING_STORE_VERSION;
+    header.dtype = static_cast<uint32_t>(EmbeddingDType::Float32);
+    header.dimension = static_cast<uint32_t>(dimension);
+    header.stride = static_cast<uint32_t>(stride);
+    header.count = count;
+    header.ids_offset = sizeof(EmbeddingStoreHeader);
+    header.vectors_offset = align_up(header.ids_offset + count * sizeof(int64_t), 64);
+    header.source_count = source_count;
+    header.source_max_id = source_max_id;
+
+    // Unique per writer so concurrent matchers refreshing the store do not collide
+    std::string tmp_path = path + "." + std::to_string(std::random_device{}()) + ".tmp";
+    try {
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent);
+        }
+
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "[EmbeddingStore] Cannot write " << tmp_path << "\n";
+            return false;
+        }
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(ids.data()), count * sizeof(int64_t));
+
+        std::vector<char> padding(header.vectors_offset - (header.ids_offset + count * sizeof(int64_t)), 0);
+        file.write(padding.data(), padding.size());
+
+        std::vector<float> row(stride, 0.0f);
+        for (size_t i = 0; i < count; i++) {
+            const float* src = vectors.data() + i * dimension;
+            float norm = std::sqrt(dot_product(src, src, dimension));
+            float inv = norm > 0.0f ? 1.0f / norm : 0.0f;
+            for (int d = 0; d < dimension; d++) {
+                row[d] = src[d] * inv;
+            }
+            file.write(reinterpret_cast<const char*>(row.data()), stride * sizeof(float));
+        }
+
+        file.close();
+        if (!file) {
+            std::cerr << "[EmbeddingStore] Failed writing " << tmp_path << "\n";
+            std::filesystem::remove(tmp_path);
+            return false;
+        }
+
+        std::filesystem::rename(tmp_path, path);
+    } catch (const std::exception& e) {
+        std::cerr << "[EmbeddingStore] Failed to write " << path << ": " << e.what() << "\n";
+        std::error_code ec;
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+
+    std::cout << "[EmbeddingStore] Wrote " << count << " embeddings (dimension " << dimension
+              << ") to " << path << "\n";
+    return true;
+}
+
+MappedEmbeddingStore::~MappedEmbeddingStore() {
+    close();
+}
+
+void MappedEmbeddingStore::close() {
+#ifdef _WIN32
+    if (base_) {
+        UnmapViewOfFile(base_);
+    }
+    if (mapping_handle_) {
+        CloseHandle(mapping_handle_);
+    }
+    if (file_handle_) {
+        CloseHandle(file_handle_);
+    }
+    file_handle_ = nullptr;
+    mapping_handle_ = nullptr;
+#else
+    if (base_) {
+        munmap(const_cast<unsigned char*>(base_), length_);
+    }
+#endif
+    base_ = nullptr;
+    length_ = 0;
+    header_ = nullptr;
+    ids_ = nullptr;
+    vectors_ = nullptr;
+}
+
+bool MappedEmbeddingStore::open(const std::string& path) {
+    close();
+
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "[EmbeddingStore] Cannot open " << path << "\n";
+        return false;
+    }
+    file_handle_ = file;
+
+    LARGE_INTEGER file_size;
+    if (!GetFileSizeEx(file, &file_size)) {
+        close();
+        return false;
+    }
+    length_ = static_cast<size_t>(file_size.QuadPart);
+
+    if (length_ > 0) {
+        mapping_handle_ = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping_handle_) {
+            std::cerr << "[EmbeddingStore] Cannot map " << path << "\n";
+            close();
+            return false;
+        }
+        base_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_handle_, FILE_MAP_READ, 0, 0, 0));
+    }
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "[EmbeddingStore] Cannot open " << path << ": " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        return false;
+    }
+    length_ = static_cast<size_t>(st.st_size);
+
+    if (length_ > 0) {
+        void* mapped = mmap(nullptr, length_, PROT_READ, MAP_SHARED, fd, 0);
+        base_ = mapped == MAP_FAILED ? nullptr : static_cast<const unsigned char*>(mapped);
+    }
+    // The mapping keeps the file referenced; the descriptor is no longer needed
+    ::close(fd);
+#endif
+
+    if (!base_) {
+        std::cerr << "[EmbeddingStore] Cannot map " << path << "\n";
+        close();
+        return false;
+    }
+
+    if (length_ < sizeof(EmbeddingStoreHeader)) {
+        std::cerr << "[EmbeddingStore] " << path << " is too small to be an embedding store\n";
+        close();
+        return false;
+    }
+
+    const auto* header = reinterpret_cast<const EmbeddingStoreHeader*>(base_);
+    if (std::memcmp(header->magic, STORE_MAGIC, sizeof(STORE_MAGIC)) != 0 ||
+        header->version != EMBEDDING_STORE_VERSION ||
+        header->dtype != static_cast<uint32_t>(EmbeddingDType::Float32)) {
+        std::cerr << "[EmbeddingStore] " << path << " has an unsupported format or version\n";
+        close();
+        return false;
+    }
+
+    uint64_t ids_end = header->ids_offset + header->count * sizeof(int64_t);
+    uint64_t vectors_end = header->vectors_offset + header->count * header->stride * sizeof(float);
+    if (header->stride != padded_row_stride(static_cast<int>(header->dimension)) ||
+        header->vectors_offset % 64 != 0 || ids_end > header->vectors_offset || vectors_end > length_) {
+        std::cerr << "[EmbeddingStore] " << path << " is truncated or corrupt\n";
+        close();
+        return false;
+    }
+
+    header_ = header;
+    ids_ = reinterpret_cast<const int64_t*>(base_ + header->ids_offset);
+    vectors_ = reinterpret_cast<const float*>(base_ + header->vectors_offset);
+    return true;
+}
@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary job-embedding store, mapped read-only so startup costs page faults
+// instead of JSON parsing and concurrent matcher processes share one copy
+// through the page cache.
+//
+// Layout (native little-endian), version 1:
+//   EmbeddingStoreHeader                     64 bytes
+//   int64_t ids[count]                       jobs.id of each row
+//   zero padding up to vectors_offset        64-byte aligned
+//   float   vectors[count][stride]           L2-normalised, rows zero-padded
+//
+// source_count / source_max_id record the jobs table when the store was
+// written so a matcher can tell when it has gone stale.
+
+const uint32_t EMBEDDING_STORE_VERSION = 1;
+
+enum class EmbeddingDType : uint32_t {
+    Float32 = 0
+};
+
+struct EmbeddingStoreHeader {
+    char magic[8];           // "AJMEMB\0\0"
+    uint32_t version;
+    uint32_t dtype;          // EmbeddingDType
+    uint32_t dimension;
+    uint32_t stride;         // Floats per stored row (dimension rounded up to 16)
+    uint64_t count;
+    uint64_t ids_offset;
+    uint64_t vectors_offset;
+    int64_t source_count;
+    int64_t source_max_id;
+};
+static_assert(sizeof(EmbeddingStoreHeader) == 64, "EmbeddingStoreHeader must stay 64 bytes");
+
+// Row length used by the store and ExactIndex: dimension rounded up to a
+// multiple of 16 floats so every row starts on a 64-byte boundary
+inline size_t padded_row_stride(int dimension) {
+    return (static_cast<size_t>(dimension) + 15) / 16 * 16;
+}
+
+// Write count row-major vectors (normalised on the way out) to path via a
+// temporary file and rename, so readers never map a half-written store
+bool write_embedding_store(const std::string& path, const std::vector<int64_t>& ids,
+                           const std::vector<float>& vectors, int dimension,
+                           int64_t source_count, int64_t source_max_id);
+
+// Read-only memory mapping of a store file
+class MappedEmbeddingStore {
+public:
+    MappedEmbeddingStore() = default;
+    ~MappedEmbeddingStore();
+
+    MappedEmbeddingStore(const MappedEmbeddingStore&) = delete;
+    MappedEmbeddingStore& operator=(const MappedEmbeddingStore&) = delete;
+
+    // Map and validate path. Returns false (and logs) on failure.
+    bool open(const std::string& path);
+
+    const EmbeddingStoreHeader& header() const { return *header_; }
+    int dimension() const { return static_cast<int>(header_->dimension); }
+    size_t stride() const { return header_->stride; }
+    size_t size() const { return header_->count; }
+    const int64_t* ids() const { return ids_; }
+    const float* vectors() const { return vectors_; }
+    // Size of the whole mapped file
+    size_t mapped_bytes() const { return length_; }
+
+private:
+    void close();
+
+    const unsigned char* base_ = nullptr;
+    size_t length_ = 0;
+#ifdef _WIN32
+    void* file_handle_ = nullptr;
+    void* mapping_handle_ = nullptr;
+#endif
+    const EmbeddingStoreHeader* header_ = nullptr;
+    const int64_t* ids_ = nullptr;
+    const float* vectors_ = nullptr;
+};
@@ -0,0 +1,166 @@
+#include "exact_index.hpp"
+#include "distance_kernels.hpp"
+#include "top_k_heap.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <new>
+#include <utility>
+
+const size_t SCAN_BLOCK_ROWS = 1024;  // Rows scored per query before moving on, sized to stay in L2
+
+static float* aligned_alloc_floats(size_t count) {
+    size_t bytes = std::max<size_t>(count, 1) * sizeof(float);
+#ifdef _WIN32
+    void* ptr = _aligned_malloc(bytes, 64);
+#else
+    void* ptr = nullptr;
+    if (posix_memalign(&ptr, 64, bytes) != 0) {
+        ptr = nullptr;
+    }
+#endif
+    if (!ptr) {
+        throw std::bad_alloc();
+    }
+    return static_cast<float*>(ptr);
+}
+
+void ExactIndex::AlignedDeleter::operator()(float* ptr) const {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+}
+
+ExactIndex::ExactIndex(int dimension)
+    : dimension_(dimension), stride_(padded_row_stride(dimension)) {}
+
+ExactIndex::ExactIndex(std::shared_ptr<const MappedEmbeddingStore> store)
+    : dimension_(store->dimension()),
+      stride_(store->stride()),
+      count_(store->size()),
+      rows_(store->vectors()),
+      row_ids_(store->ids()),
+      store_(std::move(store)) {
+    chunked_ = has_repeated_ids(row_ids_, count_);
+}
+
+void ExactIndex::reserve(size_t rows) {
+    if (rows <= capacity_) {
+        return;
+    }
+    size_t new_capacity = std::max(rows, capacity_ * 2);
+    std::unique_ptr<float[], AlignedDeleter> grown(aligned_alloc_floats(new_capacity * stride_));
+    if (count_ > 0) {
+        // rows_ may still point into a mapped store
+        std::memcpy(grown.get(), rows_, count_ * stride_ * sizeof(float));
+    }
+    if (store_) {
+        ids_.assign(row_ids_, row_ids_ + count_);
+        store_.reset();
+    }
+    data_ = std::move(grown);
+    capacity_ = new_capacity;
+    rows_ = data_.get();
+}
+
+void ExactIndex::add(const std::vector<int64_t>& ids, std::vector<float>& vectors) {
+    size_t count = ids.size();
+    size_t first = count_;
+    reserve(first + count);
+
+    for (size_t i = 0; i < count; i++) {
+        float* src = vectors.data() + i * dimension_;
+        float norm = std::sqrt(dot_product(src, src, dimension_));
+        if (norm > 0.0f) {
+            for (int d = 0; d < dimension_; d++) {
+                src[d] /= norm;
+            }
+        }
+
+        float* row = data_.get() + (first + i) * stride_;
+        std::memcpy(row, src, dimension_ * sizeof(float));
+        std::fill(row + dimension_, row + stride_, 0.0f);
+    }
+
+    ids_.insert(ids_.end(), ids.begin(), ids.end());
+    row_ids_ = ids_.data();
+    count_ = ids_.size();
+    chunked_ = has_repeated_ids(row_ids_, count_);
+}
+
+void ExactIndex::search(const float* queries, size_t nq, int k, int64_t* ids, float* scores,
+                        const IdFilter* filter) const {
+    size_t rows = count_;
+    size_t keep = std::min<size_t>(static_cast<size_t>(k), rows);
+    // Chunk rows of one job share a single heap entry
+    const int64_t* chunk_ids = chunked_ ? row_ids_ : nullptr;
+
+    // Queries padded to the row stride so the kernel sees identical layouts
+    // Scratch is per thread and reused, so concurrent searches neither share nor reallocate it
+    static thread_local std::vector<float> padded;
+    padded.assign(nq * stride_, 0.0f);
+    for (size_t q = 0; q < nq; q++) {
+        std::memcpy(padded.data() + q * stride_, queries + q * dimension_, dimension_ * sizeof(float));
+    }
+
+    // One bounded min-heap per query: the root is the weakest kept result
+    static thread_local std::vector<std::vector<ScoredRow>> heaps;
+    if (heaps.size() < nq) {
+        heaps.resize(nq);
+    }
+    for (size_t q = 0; q < nq; q++) {
+        heaps[q].clear();
+        heaps[q].reserve(keep + 1);
+    }
+
+    for (size_t block = 0; block < rows; block += SCAN_BLOCK_ROWS) {
+        size_t block_end = std::min(rows, block + SCAN_BLOCK_ROWS);
+        for (size_t q = 0; q < nq; q++) {
+            const float* query = padded.data() + q * stride_;
+            auto& heap = heaps[q];
+            for (size_t r = block; r < block_end; r++) {
+                if (filter && !filter->contains(row_ids_[r])) {
+                    continue;
+                }
+                float score = dot_product(query, rows_ + r * stride_, stride_);
+                offer_top_k(heap, keep, score, r, chunk_ids);
+            }
+        }
+    }
+
+    for (size_t q = 0; q < nq; q++) {
+        auto& heap = heaps[q];
+        std::sort_heap(heap.begin(), heap.end(), std::greater<ScoredRow>());
+        for (int i = 0; i < k; i++) {
+            size_t slot = q * k + i;
+            if (static_cast<size_t>(i) < heap.size()) {
+                ids[slot] = row_ids_[heap[i].second];
+                scores[slot] = heap[i].first;
+            } else {
+                ids[slot] = -1;
+                scores[slot] = -std::numeric_limits<float>::infinity();
+            }
+        }
+    }
+}
+
+void search_top_matches(const ExactIndex* index, const std::vector<float>& query,
+                        int k, std::vector<int64_t>& ids, std::vector<float>& scores,
+                        const IdFilter* filter) {
+    ids.resize(k);
+    scores.resize(k);
+    index->search(query.data(), 1, k, ids.data(), scores.data(), filter);
+}
+
+void search_top_matches_batch(const ExactIndex* index, const std::vector<float>& queries,
+                              size_t nq, int k, std::vector<int64_t>& ids,
+                              std::vector<float>& scores, const IdFilter* filter) {
+    ids.resize(nq * k);
+    scores.resize(nq * k);
+    index->search(queries.data(), nq, k, ids.data(), scores.data(), filter);
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "embedding_store.hpp"
+#include "id_filter.hpp"
+
+// Exact cosine-similarity index without a FAISS dependency. Vectors are
+// L2-normalised and stored row-major in a 64-byte aligned buffer with each
+// row padded to a multiple of 16 floats, so every row starts on a cache line
+// and the SIMD kernels never need a scalar tail.
+class ExactIndex {
+public:
+    explicit ExactIndex(int dimension);
+
+    // Zero-copy index over a mapped store, which the index keeps alive
+    explicit ExactIndex(std::shared_ptr<const MappedEmbeddingStore> store);
+
+    // Append count row-major vectors keyed by ids; vectors are normalised in place.
+    // An index over a mapped store copies it into owned memory first. Several
+    // rows may share an id (chunks of one long job description).
+    void add(const std::vector<int64_t>& ids, std::vector<float>& vectors);
+
+    // Exact top-k for nq row-major queries (assumed normalised). Results for
+    // query q occupy ids/scores[q * k, (q + 1) * k) in descending score order;
+    // unused slots get id -1, mirroring FAISS. With a filter, rows whose id
+    // it does not contain are skipped before they are scored. Ids are
+    // distinct: a job with several chunk rows scores as its best chunk.
+    void search(const float* queries, size_t nq, int k, int64_t* ids, float* scores,
+                const IdFilter* filter = nullptr) const;
+
+    int dimension() const { return dimension_; }
+    size_t size() const { return count_; }
+    // Whether some job has more than one row
+    bool chunked() const { return chunked_; }
+    // Bytes of the padded rows and ids, whether owned or mapped
+    size_t memory_bytes() const { return count_ * (stride_ * sizeof(float) + sizeof(int64_t)); }
+
+private:
+    struct AlignedDeleter {
+        void operator()(float* ptr) const;
+    };
+
+    void reserve(size_t rows);
+
+    int dimension_;
+    size_t stride_;   // Padded row length in floats
+    size_t count_ = 0;
+    size_t capacity_ = 0;
+    bool chunked_ = false;
+    // rows_/row_ids_ point either into the owned buffers or into store_
+    const float* rows_ = nullptr;
+    const int64_t* row_ids_ = nullptr;
+    std::unique_ptr<float[], AlignedDeleter> data_;
+    std::vector<int64_t> ids_;
+    std::shared_ptr<const MappedEmbeddingStore> store_;
+};
+
+void search_top_matches(const ExactIndex* index, const std::vector<float>& query,
+                        int k, std::vector<int64_t>& ids, std::vector<float>& scores,
+                        const IdFilter* filter = nullptr);
+
+void search_top_matches_batch(const ExactIndex* index, const std::vector<float>& queries,
+                              size_t nq, int k, std::vector<int64_t>& ids,
+                              std::vector<float>& scores, const IdFilter* filter = nullptr);
@@ -1,22 +1,238 @@
 #include "faiss_matcher.hpp"
-#include <iostream> 
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <random>
 #include <faiss/IndexFlat.h>
+#include <faiss/IndexHNSW.h>
 #include <faiss/IndexIDMap.h>
+#include <faiss/IndexIVFFlat.h>
+#include <faiss/IndexIVFPQ.h>
+#include <faiss/index_factory.h>
 #include <faiss/index_io.h>
+#include <faiss/impl/IDSelector.h>
+#include <faiss/invlists/InvertedLists.h>
+#include <faiss/utils/distances.h>
 
-faiss::IndexIDMap* load_faiss_index(const std::string& path) {
+static faiss::IndexIDMap* wrap_with_ids(faiss::Index* base) {
+    auto* index = new faiss::IndexIDMap(base);
+    index->own_fields = true;
+    return index;
+}
+
+// Inner index of an id map, or the index itself
+static const faiss::Index* unwrap(const faiss::Index* index) {
+    if (auto* id_map = dynamic_cast<const faiss::IndexIDMap*>(index)) {
+        return id_map->index;
+    }
+    return index;
+}
+
+faiss::Index* load_faiss_index(const std::string& path) {
+    faiss::Index* base = nullptr;
     try {
-        faiss::Index* base = faiss::read_index(path.c_str());
-        return new faiss::IndexIDMap(base);
+        base = faiss::read_index(path.c_str());
     } catch (...) {
         std::cerr << "[FAISS] Failed to load index from " << path << "\n";
         return nullptr;
     }
+
+    // Indexes written by save_faiss_index already carry job ids
+    if (dynamic_cast<faiss::IndexIDMap*>(base) || faiss::try_extract_index_ivf(base)) {
+        return base;
+    }
+
+    // A bare index: wrap it so labels keep meaning row positions
+    auto* index = wrap_with_ids(base);
+    index->id_map.resize(base->ntotal);
+    std::iota(index->id_map.begin(), index->id_map.end(), faiss::idx_t(0));
+    index->ntotal = base->ntotal;
+    return index;
+}
+
+bool save_faiss_index(const faiss::Index* index, const std::string& path) {
+    // Unique per writer so concurrent updates do not collide
+    std::string tmp_path = path + "." + std::to_string(std::random_device{}()) + ".tmp";
+    try {
+        std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (!parent.empty()) {
+            std::filesystem::create_directories(parent);
+        }
+        faiss::write_index(index, tmp_path.c_str());
+        std::filesystem::rename(tmp_path, path);
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "[FAISS] Failed to save index to " << path << ": " << e.what() << "\n";
+        std::error_code ec;
+        std::filesystem::remove(tmp_path, ec);
+        return false;
+    }
+}
+
+// About 4 * sqrt(n) cells, keeping at least 39 training vectors per cell
+static int default_nlist(size_t count) {
+    int nlist = static_cast<int>(4.0 * std::sqrt(static_cast<double>(count)));
+    nlist = std::min(nlist, static_cast<int>(count / 39));
+    return std::max(nlist, 1);
+}
+
+// Largest divisor of the dimension not above dimension / 16, i.e. sub-vectors
+// of at least 16 floats (64 one-byte codes for 1024-d Cohere vectors)
+static int default_pq_m(int dimension) {
+    for (int m = std::max(dimension / 16, 1); m > 1; m--) {
+        if (dimension % m == 0) {
+            return m;
+        }
+    }
+    return 1;
+}
+
+faiss::Index* build_faiss_index(const std::vector<int64_t>& ids, std::vector<float>& vectors,
+                                int dimension, const FaissIndexOptions& options) {
+    size_t count = ids.size();
+    int nlist = options.nlist > 0 ? options.nlist : default_nlist(count);
+    int pq_m = options.pq_m > 0 ? options.pq_m : default_pq_m(dimension);
+
+    std::string description;
+    if (options.type == "flat") {
+        description = "Flat";
+    } else if (options.type == "ivf-flat") {
+        description = "IVF" + std::to_string(nlist) + ",Flat";
+    } else if (options.type == "ivf-pq") {
+        description = "IVF" + std::to_string(nlist) + ",PQ" + std::to_string(pq_m);
+    } else if (options.type == "hnsw") {
+        description = "HNSW" + std::to_string(options.hnsw_m) + ",Flat";
+    } else {
+        std::cerr << "[FAISS] Unknown index type: " << options.type << "\n";
+        return nullptr;
+    }
+
+    try {
+        faiss::normalize_L2(dimension, count, vectors.data());
+
+        std::unique_ptr<faiss::Index> index(
+            faiss::index_factory(dimension, description.c_str(), faiss::METRIC_INNER_PRODUCT));
+        if (!index->is_trained) {
+            index->train(count, vectors.data());
+        }
+        // IVF lists store the job ids themselves; everything else needs an id map
+        if (!faiss::try_extract_index_ivf(index.get())) {
+            index.reset(wrap_with_ids(index.release()));
+        }
+        index->add_with_ids(count, vectors.data(), ids.data());
+        set_search_parameters(index.get(), options);
+
+        std::cout << "[FAISS] Built " << description << " index over " << count << " jobs\n";
+        return index.release();
+    } catch (const std::exception& e) {
+        std::cerr << "[FAISS] Failed to build " << description << " index: " << e.what() << "\n";
+        return nullptr;
+    }
 }
 
-void search_top_matches(faiss::IndexIDMap* index, const std::vector<float>& query,
-                        int k, std::vector<faiss::idx_t>& ids, std::vector<float>& scores) {
-    ids.resize(k);
-    scores.resize(k);
-    index->search(1, query.data(), k, scores.data(), ids.data());
+faiss::Index* build_flat_index(const std::vector<int64_t>& ids,
+                               std::vector<float>& vectors, int dimension) {
+    return build_faiss_index(ids, vectors, dimension, FaissIndexOptions());
+}
+
+std::string faiss_index_type(const faiss::Index* index) {
+    const faiss::Index* inner = unwrap(index);
+    if (dynamic_cast<const faiss::IndexIVFPQ*>(inner)) {
+        return "ivf-pq";
+    }
+    if (dynamic_cast<const faiss::IndexIVFFlat*>(inner)) {
+        return "ivf-flat";
+    }
+    if (dynamic_cast<const faiss::IndexHNSW*>(inner)) {
+        return "hnsw";
+    }
+    if (dynamic_cast<const faiss::IndexFlat*>(inner)) {
+        return "flat";
+    }
+    return "unknown";
+}
+
+void set_search_parameters(faiss::Index* index, const FaissIndexOptions& options) {
+    if (faiss::IndexIVF* ivf = faiss::try_extract_index_ivf(index)) {
+        ivf->nprobe = static_cast<size_t>(std::clamp<int>(options.nprobe, 1, static_cast<int>(ivf->nlist)));
+    }
+    if (auto* hnsw = dynamic_cast<faiss::IndexHNSW*>(const_cast<faiss::Index*>(unwrap(index)))) {
+        hnsw->hnsw.efSearch = std::max(options.ef_search, 1);
+    }
+}
+
+bool faiss_index_supports_removal(const faiss::Index* index) {
+    return dynamic_cast<const faiss::IndexHNSW*>(unwrap(index)) == nullptr;
+}
+
+std::vector<int64_t> faiss_index_ids(const faiss::Index* index) {
+    std::vector<int64_t> ids = faiss_index_labels(index);
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    return ids;
+}
+
+std::vector<int64_t> faiss_index_labels(const faiss::Index* index) {
+    std::vector<int64_t> ids;
+    if (auto* id_map = dynamic_cast<const faiss::IndexIDMap*>(index)) {
+        ids.assign(id_map->id_map.begin(), id_map->id_map.end());
+    } else if (faiss::IndexIVF* ivf = faiss::try_extract_index_ivf(const_cast<faiss::Index*>(index))) {
+        ids.reserve(static_cast<size_t>(ivf->ntotal));
+        for (size_t list = 0; list < ivf->nlist; list++) {
+            size_t size = ivf->invlists->list_size(list);
+            faiss::InvertedLists::ScopedIds list_ids(ivf->invlists, list);
+            ids.insert(ids.end(), list_ids.get(), list_ids.get() + size);
+        }
+    }
+    std::sort(ids.begin(), ids.end());
+    return ids;
+}
+
+// Upper bound on the efSearch a selective filter can raise HNSW to
+const int MAX_FILTERED_EF_SEARCH = 2048;
+
+// Search parameters of the type the index expects, seeded with its own
+// nprobe/efSearch so attaching a selector does not reset them. A filter
+// admitting only a fraction of the jobs leaves proportionally fewer
+// admissible vectors in each IVF cell or HNSW neighbourhood, so both knobs
+// are widened by 1 / fraction to keep the filtered top-k full.
+static std::unique_ptr<faiss::SearchParameters> make_search_parameters(faiss::Index* index, double fraction) {
+    double widen = fraction > 0.0 ? std::min(1.0 / fraction, 1e6) : 1e6;
+    if (faiss::IndexIVF* ivf = faiss::try_extract_index_ivf(index)) {
+        auto params = std::make_unique<faiss::SearchParametersIVF>();
+        params->nprobe = std::min(ivf->nlist, static_cast<size_t>(std::ceil(ivf->nprobe * widen)));
+        return params;
+    }
+    if (auto* hnsw = dynamic_cast<const faiss::IndexHNSW*>(unwrap(index))) {
+        auto params = std::make_unique<faiss::SearchParametersHNSW>();
+        int ef = hnsw->hnsw.efSearch;
+        params->efSearch = std::max(ef, static_cast<int>(std::min<double>(ef * widen, MAX_FILTERED_EF_SEARCH)));
+        return params;
+    }
+    return std::make_unique<faiss::SearchParameters>();
+}
+
+void search_top_matches(faiss::Index* index, const std::vector<float>& query,
+                        int k, std::vector<faiss::idx_t>& ids, std::vector<float>& scores,
+                        const IdFilter* filter) {
+    search_top_matches_batch(index, query, 1, k, ids, scores, filter);
+}
+
+void search_top_matches_batch(faiss::Index* index, const std::vector<float>& queries,
+                              size_t nq, int k, std::vector<faiss::idx_t>& ids,
+                              std::vector<float>& scores, const IdFilter* filter) {
+    ids.resize(nq * k);
+    scores.resize(nq * k);
+    if (!filter) {
+        index->search(nq, queries.data(), k, scores.data(), ids.data());
+        return;
+    }
+
+    faiss::IDSelectorBitmap selector(filter->bitmap().size(), filter->bitmap().data());
+    double fraction = index->ntotal > 0 ? static_cast<double>(filter->count()) / index->ntotal : 1.0;
+    std::unique_ptr<faiss::SearchParameters> params = make_search_parameters(index, fraction);
+    params->sel = &selector;
+    index->search(nq, queries.data(), k, scores.data(), ids.data(), params.get());
 }
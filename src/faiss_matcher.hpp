@@ -1,9 +1,55 @@
 #pragma once
+#include <cstdint>
 #include <string>
 #include <vector>
-#include <faiss/IndexIDMap.h>
+#include <faiss/Index.h>
+#include "faiss_options.hpp"
+#include "id_filter.hpp"
 
-faiss::IndexIDMap* load_faiss_index(const std::string& path);
+// Every index handed out here labels its vectors with jobs.id: IVF indexes
+// store the ids natively, flat and HNSW indexes sit inside an IndexIDMap.
 
-void search_top_matches(faiss::IndexIDMap* index, const std::vector<float>& query,
-                        int k, std::vector<faiss::idx_t>& ids, std::vector<float>& scores);
+// Load an index written by save_faiss_index. An index saved without ids is
+// wrapped in an id map that maps positions to themselves.
+faiss::Index* load_faiss_index(const std::string& path);
+
+// Write the index to a temporary file and rename it over path, so readers
+// never see a partially written index
+bool save_faiss_index(const faiss::Index* index, const std::string& path);
+
+// Build an inner-product index of options.type over L2-normalised vectors
+// (cosine similarity), keyed by the jobs.id values in ids. vectors is
+// normalised in place. IVF types are trained on the same vectors.
+faiss::Index* build_faiss_index(const std::vector<int64_t>& ids, std::vector<float>& vectors,
+                                int dimension, const FaissIndexOptions& options);
+
+// Exact flat index, the reference the approximate types are measured against
+faiss::Index* build_flat_index(const std::vector<int64_t>& ids,
+                               std::vector<float>& vectors, int dimension);
+
+// "flat", "ivf-flat", "ivf-pq", "hnsw", or "unknown"
+std::string faiss_index_type(const faiss::Index* index);
+
+// Apply the query-time knobs (nprobe for IVF, efSearch for HNSW)
+void set_search_parameters(faiss::Index* index, const FaissIndexOptions& options);
+
+// HNSW graphs cannot delete vectors; they have to be rebuilt instead
+bool faiss_index_supports_removal(const faiss::Index* index);
+
+// The distinct jobs.id labels held by the index, ascending
+std::vector<int64_t> faiss_index_ids(const faiss::Index* index);
+
+// The label of every vector in the index, ascending; a job embedded as
+// several chunks appears once per chunk
+std::vector<int64_t> faiss_index_labels(const faiss::Index* index);
+
+void search_top_matches(faiss::Index* index, const std::vector<float>& query,
+                        int k, std::vector<faiss::idx_t>& ids, std::vector<float>& scores,
+                        const IdFilter* filter = nullptr);
+
+// Search nq row-major queries in one call; results for query q occupy
+// ids/scores[q * k, (q + 1) * k). A filter is passed to FAISS as an
+// IDSelectorBitmap, with nprobe/efSearch widened by how selective it is.
+void search_top_matches_batch(faiss::Index* index, const std::vector<float>& queries,
+                              size_t nq, int k, std::vector<faiss::idx_t>& ids,
+                              std::vector<float>& scores, const IdFilter* filter = nullptr);
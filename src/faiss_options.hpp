@@ -0,0 +1,18 @@
+#pragma once
+#include <string>
+
+// Which FAISS index holds the jobs and how hard it searches. The build
+// fields only matter when the index is (re)built; nprobe and ef_search trade
+// recall for latency on every query.
+struct FaissIndexOptions {
+    std::string type = "flat"; // flat, ivf-flat, ivf-pq or hnsw
+    int nlist = 0;             // IVF cells; 0 picks about 4 * sqrt(jobs)
+    int pq_m = 0;              // PQ sub-quantizers for ivf-pq; 0 picks dimension / 16
+    int hnsw_m = 32;           // HNSW graph degree
+    int nprobe = 16;           // IVF cells scanned per query
+    int ef_search = 64;        // HNSW candidate list size per query
+};
+
+inline bool is_faiss_index_type(const std::string& type) {
+    return type == "flat" || type == "ivf-flat" || type == "ivf-pq" || type == "hnsw";
+}
@@ -0,0 +1,399 @@
+#include "fetch_engine.hpp"
+#include <algorithm>
+#include <iostream>
+#include <random>
+
+std::string FetchResult::error() const {
+    if (curl_code != CURLE_OK) {
+        return curl_easy_strerror(curl_code);
+    }
+    if (http_code < 200 || http_code >= 300) {
+        return "HTTP " + std::to_string(http_code);
+    }
+    return std::string();
+}
+
+static size_t write_body(char* data, size_t size, size_t count, void* body) {
+    static_cast<std::string*>(body)->append(data, size * count);
+    return size * count;
+}
+
+// Only touched by the engine thread
+static std::mt19937& engine_random() {
+    static std::mt19937 random(std::random_device{}());
+    return random;
+}
+
+// Idle handles kept per site for reuse
+const size_t MAX_IDLE_HANDLES_PER_SITE = 8;
+
+FetchEngine::FetchEngine(const FetchEngineOptions& options) : options_(options) {
+    options_.max_in_flight = std::max<size_t>(options_.max_in_flight, 1);
+    options_.max_streams_per_host = std::max(options_.max_streams_per_host, 1L);
+    if (options_.http2 && !(curl_version_info(CURLVERSION_NOW)->features & CURL_VERSION_HTTP2)) {
+        std::cerr << "[FetchEngine] libcurl was built without HTTP/2; using HTTP/1.1\n";
+        options_.http2 = false;
+    }
+
+    share_ = curl_share_init();
+    if (share_) {
+        curl_share_setopt(share_, CURLSHOPT_LOCKFUNC, &FetchEngine::lock_share);
+        curl_share_setopt(share_, CURLSHOPT_UNLOCKFUNC, &FetchEngine::unlock_share);
+        curl_share_setopt(share_, CURLSHOPT_USERDATA, this);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+        curl_share_setopt(share_, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+    }
+
+    multi_ = curl_multi_init();
+    if (!multi_) {
+        std::cerr << "[FetchEngine] curl_multi_init failed\n";
+        return;
+    }
+    // Room to keep a warm connection to every site between requests
+    curl_multi_setopt(multi_, CURLMOPT_MAXCONNECTS, static_cast<long>(options_.max_in_flight));
+    if (options_.http2) {
+        curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+        curl_multi_setopt(multi_, CURLMOPT_MAX_CONCURRENT_STREAMS, options_.max_streams_per_host);
+    }
+    loop_ = std::thread(&FetchEngine::run, this);
+}
+
+FetchEngine::~FetchEngine() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    if (multi_) {
+        curl_multi_wakeup(multi_);
+    }
+    if (loop_.joinable()) {
+        loop_.join();
+    }
+    for (auto& entry : idle_handles_) {
+        for (CURL* handle : entry.second) {
+            curl_easy_cleanup(handle);
+        }
+    }
+    idle_handles_.clear();
+    if (multi_) {
+        curl_multi_cleanup(multi_);
+    }
+    if (share_) {
+        // Pooled handles have no jar file set, so the shared jar is written
+        // here exactly once per file, by a handle that exists only for that
+        for (const std::string& file : cookie_files_) {
+            CURL* writer = curl_easy_init();
+            if (writer) {
+                curl_easy_setopt(writer, CURLOPT_SHARE, share_);
+                curl_easy_setopt(writer, CURLOPT_COOKIEJAR, file.c_str());
+                curl_easy_cleanup(writer);
+            }
+        }
+        curl_share_cleanup(share_);
+    }
+}
+
+void FetchEngine::lock_share(CURL*, curl_lock_data data, curl_lock_access, void* engine) {
+    static_cast<FetchEngine*>(engine)->share_locks_[data].lock();
+}
+
+void FetchEngine::unlock_share(CURL*, curl_lock_data data, void* engine) {
+    static_cast<FetchEngine*>(engine)->share_locks_[data].unlock();
+}
+
+void FetchEngine::set_site_policy(const std::string& site, const SitePolicy& policy) {
+    RateLimit limit;
+    limit.interval = policy.min_interval;
+    limit.jitter = policy.jitter;
+    limit.burst = policy.burst;
+    limiter_.set_limit(site, limit);
+    std::lock_guard<std::mutex> lock(mutex_);
+    sites_[site].policy = policy;
+}
+
+void FetchEngine::pause_site(const std::string& site, std::chrono::milliseconds cooldown) {
+    limiter_.pause(site, cooldown);
+}
+
+void FetchEngine::submit(FetchRequest request, FetchCallback on_done) {
+    auto transfer = std::make_unique<Transfer>();
+    transfer->request = std::move(request);
+    transfer->on_done = std::move(on_done);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!stopping_ && multi_) {
+            sites_[transfer->request.site].queue.push_back(std::move(transfer));
+        }
+    }
+    if (transfer) {
+        transfer->result.curl_code = CURLE_ABORTED_BY_CALLBACK;
+        deliver(std::move(transfer));
+        return;
+    }
+    curl_multi_wakeup(multi_);
+}
+
+std::future<FetchResult> FetchEngine::fetch(FetchRequest request) {
+    auto promise = std::make_shared<std::promise<FetchResult>>();
+    std::future<FetchResult> result = promise->get_future();
+    submit(std::move(request), [promise](FetchResult& done) { promise->set_value(std::move(done)); });
+    return result;
+}
+
+FetchEngine::Clock::time_point FetchEngine::start_eligible(Clock::time_point now,
+                                                          std::vector<std::unique_ptr<Transfer>>& ready) {
+    Clock::time_point wake = Clock::time_point::max();
+    for (auto& entry : sites_) {
+        SiteState& site = entry.second;
+        while (!site.queue.empty() && site.in_flight < site.policy.max_in_flight &&
+               in_flight_ + ready.size() < options_.max_in_flight) {
+            Clock::time_point eligible = site.queue.front()->not_before;
+            if (eligible <= now) {
+                // Takes the site's token when one is due
+                eligible = limiter_.try_acquire(entry.first, now);
+            }
+            if (eligible > now) {
+                wake = std::min(wake, eligible);
+                break;
+            }
+            ready.push_back(std::move(site.queue.front()));
+            site.queue.pop_front();
+            site.in_flight++;
+        }
+    }
+    return wake;
+}
+
+bool FetchEngine::start(Transfer& transfer) {
+    const FetchRequest& request = transfer.request;
+    transfer.result.body.clear();
+    std::vector<CURL*>& idle = idle_handles_[request.site];
+    if (!idle.empty()) {
+        // Reset keeps the handle's place in the share
+        transfer.handle = idle.back();
+        idle.pop_back();
+        curl_easy_reset(transfer.handle);
+    } else {
+        transfer.handle = curl_easy_init();
+    }
+    if (!transfer.handle) {
+        transfer.result.curl_code = CURLE_FAILED_INIT;
+        return false;
+    }
+
+    CURL* curl = transfer.handle;
+    if (share_) {
+        curl_easy_setopt(curl, CURLOPT_SHARE, share_);
+    }
+    curl_easy_setopt(curl, CURLOPT_TCP_KEEPALIVE, 1L);
+    if (options_.http2) {
+        // HTTP/2 where TLS negotiates it; wait for a connection that may
+        // multiplex instead of opening a parallel one
+        curl_easy_setopt(curl, CURLOPT_HTTP_VERSION, static_cast<long>(CURL_HTTP_VERSION_2TLS));
+        curl_easy_setopt(curl, CURLOPT_PIPEWAIT, 1L);
+    }
+    curl_easy_setopt(curl, CURLOPT_URL, request.url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_body);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &transfer.result.body);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, request.timeout_seconds);
+    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, request.connect_timeout_seconds);
+    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, request.verify_peer ? 1L : 0L);
+    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, request.accept_encoding.c_str());
+    // Reading a file again would overwrite newer cookies in the shared jar
+    // with what it held at startup, so each file is read only once
+    if (!request.cookie_file.empty() && cookie_files_.insert(request.cookie_file).second) {
+        curl_easy_setopt(curl, CURLOPT_COOKIEFILE, request.cookie_file.c_str());
+    } else {
+        curl_easy_setopt(curl, CURLOPT_COOKIEFILE, "");
+    }
+    if (!request.user_agent.empty()) {
+        curl_easy_setopt(curl, CURLOPT_USERAGENT, request.user_agent.c_str());
+    }
+    if (!request.proxy.empty()) {
+        curl_easy_setopt(curl, CURLOPT_PROXY, request.proxy.c_str());
+    }
+    if (request.verbose) {
+        curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
+    }
+    for (const std::string& header : request.headers) {
+        transfer.headers = curl_slist_append(transfer.headers, header.c_str());
+    }
+    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, transfer.headers);
+
+    CURLMcode added = curl_multi_add_handle(multi_, curl);
+    if (added != CURLM_OK) {
+        std::cerr << "[FetchEngine] Cannot start " << request.url << ": " << curl_multi_strerror(added) << "\n";
+        transfer.result.curl_code = CURLE_FAILED_INIT;
+        return false;
+    }
+    return true;
+}
+
+void FetchEngine::release(Transfer& transfer) {
+    if (transfer.handle) {
+        std::vector<CURL*>& idle = idle_handles_[transfer.request.site];
+        if (idle.size() < MAX_IDLE_HANDLES_PER_SITE) {
+            idle.push_back(transfer.handle);
+        } else {
+            curl_easy_cleanup(transfer.handle);
+        }
+        transfer.handle = nullptr;
+    }
+    curl_slist_free_all(transfer.headers);
+    transfer.headers = nullptr;
+}
+
+std::chrono::milliseconds FetchEngine::retry_delay(const Transfer& transfer) const {
+    const FetchResult& result = transfer.result;
+    if (result.ok() || result.attempts >= transfer.request.attempts ||
+        result.curl_code == CURLE_ABORTED_BY_CALLBACK) {
+        return std::chrono::milliseconds(0);
+    }
+    if (result.curl_code == CURLE_OK && result.http_code == 429) {
+        return std::chrono::seconds(60 * result.attempts);
+    }
+    if (result.curl_code == CURLE_OK && result.http_code < 500) {
+        // Not found, forbidden and the like will not change on a retry
+        return std::chrono::milliseconds(0);
+    }
+    return std::chrono::seconds(3 * result.attempts + engine_random()() % 5);
+}
+
+void FetchEngine::finish(CURL* handle, CURLcode code) {
+    auto it = running_.find(handle);
+    if (it == running_.end()) {
+        return;
+    }
+    std::unique_ptr<Transfer> transfer = std::move(it->second);
+    running_.erase(it);
+    curl_multi_remove_handle(multi_, handle);
+    in_flight_--;
+
+    FetchResult& result = transfer->result;
+    result.curl_code = code;
+    result.http_code = 0;
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &result.http_code);
+    result.attempts++;
+    release(*transfer);
+    if (code != CURLE_ABORTED_BY_CALLBACK) {
+        limiter_.record(transfer->request.site, result.ok(), code == CURLE_OK ? result.http_code : 0);
+    }
+
+    std::chrono::milliseconds delay = retry_delay(*transfer);
+    if (delay.count() > 0) {
+        std::cerr << "[FetchEngine] " << transfer->request.url << ": " << result.error() << ", retrying in "
+                  << delay.count() / 1000.0 << " s\n";
+        if (code == CURLE_BAD_CONTENT_ENCODING) {
+            transfer->request.accept_encoding = "identity";
+        }
+        transfer->not_before = Clock::now() + delay;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    SiteState& site = sites_[transfer->request.site];
+    site.in_flight--;
+    if (delay.count() > 0) {
+        // Retries keep their place at the head of the site's queue
+        site.queue.push_front(std::move(transfer));
+    } else {
+        finished_.push_back(std::move(transfer));
+    }
+}
+
+void FetchEngine::deliver(std::unique_ptr<Transfer> transfer) {
+    release(*transfer);
+    if (!transfer->on_done) {
+        return;
+    }
+    try {
+        transfer->on_done(transfer->result);
+    } catch (const std::exception& e) {
+        std::cerr << "[FetchEngine] Callback for " << transfer->request.url << " threw: " << e.what() << "\n";
+    }
+}
+
+void FetchEngine::run() {
+    std::vector<std::unique_ptr<Transfer>> ready;
+    std::vector<std::unique_ptr<Transfer>> done;
+    while (true) {
+        Clock::time_point wake;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (stopping_) {
+                break;
+            }
+            wake = start_eligible(Clock::now(), ready);
+            done.swap(finished_);
+        }
+
+        // Callbacks may submit more work, so they run without the lock
+        for (std::unique_ptr<Transfer>& transfer : done) {
+            deliver(std::move(transfer));
+        }
+        done.clear();
+
+        for (std::unique_ptr<Transfer>& transfer : ready) {
+            if (!start(*transfer)) {
+                std::lock_guard<std::mutex> lock(mutex_);
+                sites_[transfer->request.site].in_flight--;
+                finished_.push_back(std::move(transfer));
+                continue;
+            }
+            in_flight_++;
+            CURL* handle = transfer->handle;
+            running_[handle] = std::move(transfer);
+        }
+        ready.clear();
+
+        int still_running = 0;
+        curl_multi_perform(multi_, &still_running);
+        int queued = 0;
+        while (CURLMsg* message = curl_multi_info_read(multi_, &queued)) {
+            if (message->msg == CURLMSG_DONE) {
+                finish(message->easy_handle, message->data.result);
+            }
+        }
+
+        int timeout_ms = 1000;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!finished_.empty()) {
+                timeout_ms = 0;
+            }
+        }
+        if (timeout_ms > 0 && wake != Clock::time_point::max()) {
+            auto until_wake = std::chrono::duration_cast<std::chrono::milliseconds>(wake - Clock::now());
+            timeout_ms = static_cast<int>(std::clamp<long long>(until_wake.count(), 0, timeout_ms));
+        }
+        curl_multi_poll(multi_, nullptr, 0, timeout_ms, nullptr);
+    }
+
+    // Shutting down: nothing in flight or queued will complete
+    for (auto& entry : running_) {
+        curl_multi_remove_handle(multi_, entry.first);
+        entry.second->result.curl_code = CURLE_ABORTED_BY_CALLBACK;
+        done.push_back(std::move(entry.second));
+    }
+    running_.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (std::unique_ptr<Transfer>& transfer : finished_) {
+            done.push_back(std::move(transfer));
+        }
+        finished_.clear();
+        for (auto& entry : sites_) {
+            for (std::unique_ptr<Transfer>& transfer : entry.second.queue) {
+                transfer->result.curl_code = CURLE_ABORTED_BY_CALLBACK;
+                done.push_back(std::move(transfer));
+            }
+            entry.second.queue.clear();
+        }
+    }
+    for (std::unique_ptr<Transfer>& transfer : done) {
+        deliver(std::move(transfer));
+    }
+}
@@ -0,0 +1,151 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <curl/curl.h>
+#include "rate_limiter.hpp"
+
+// One HTTP GET for the FetchEngine
+struct FetchRequest {
+    std::string url;
+    std::string site;                 // Politeness key; requests without one are never held back
+    std::string user_agent;
+    std::vector<std::string> headers; // Raw "Name: value" lines
+    std::string cookie_file;          // Read into the shared cookie jar once and written back at shutdown; may be empty
+    std::string accept_encoding;      // CURLOPT_ACCEPT_ENCODING; empty accepts every encoding curl supports
+    std::string proxy;
+    long timeout_seconds = 30;
+    long connect_timeout_seconds = 10;
+    bool verify_peer = true;
+    bool verbose = false;
+    int attempts = 1;                 // Tries for transient failures (curl errors, 429, 5xx)
+};
+
+struct FetchResult {
+    CURLcode curl_code = CURLE_OK;
+    long http_code = 0;
+    std::string body;
+    int attempts = 0;
+
+    bool ok() const { return curl_code == CURLE_OK && http_code >= 200 && http_code < 300; }
+    // curl error text or "HTTP <code>"; empty when ok()
+    std::string error() const;
+};
+
+// Invoked on the engine thread once a request has finished, successfully or
+// not. Parse elsewhere: a slow callback stalls every transfer.
+using FetchCallback = std::function<void(FetchResult&)>;
+
+// How hard the engine may hit one site
+struct SitePolicy {
+    std::chrono::milliseconds min_interval{0}; // Between request starts, once the burst is spent
+    std::chrono::milliseconds jitter{0};       // Random extra spacing, up to this much
+    double burst = 1.0;                        // Requests that may start back to back
+    size_t max_in_flight = 4;
+};
+
+struct FetchEngineOptions {
+    size_t max_in_flight = 32;     // Transfers running at once across all sites
+    // Negotiate HTTP/2 over TLS and multiplex concurrent requests to a host
+    // over one connection, where the server and libcurl support it
+    bool http2 = true;
+    long max_streams_per_host = 8; // Concurrent HTTP/2 streams on one connection
+};
+
+// Asynchronous HTTP client on the curl multi interface. One thread drives
+// every transfer, so many requests stay in flight across sites while each
+// site's queue is released no faster than its SitePolicy allows. Requests
+// to one site start in submission order. submit() and fetch() may be called
+// from any thread.
+//
+// Spacing comes from a token bucket per site (RateLimiter) that sees every
+// response, so a site that starts throttling is slowed down and one that
+// recovers is sped up again without the callers noticing.
+//
+// Easy handles are pooled per site and reset between requests, and every
+// handle uses one share object for cookies, the DNS cache, TLS sessions and
+// the connection cache. Successive requests to a site thereby
+// reuse a warm connection instead of paying for DNS, TCP and TLS again.
+// With HTTP/2, requests to a host wait for its existing connection rather
+// than opening more, and run as streams over it.
+class FetchEngine {
+public:
+    explicit FetchEngine(const FetchEngineOptions& options = FetchEngineOptions());
+    // Fails queued requests with CURLE_ABORTED_BY_CALLBACK, aborts running
+    // ones the same way, joins the engine thread, then writes the cookie jar
+    // to every cookie file requests named
+    ~FetchEngine();
+
+    FetchEngine(const FetchEngine&) = delete;
+    FetchEngine& operator=(const FetchEngine&) = delete;
+
+    // Applies to requests of site started from now on
+    void set_site_policy(const std::string& site, const SitePolicy& policy);
+
+    // Start no request of site for cooldown; other sites' requests carry on
+    void pause_site(const std::string& site, std::chrono::milliseconds cooldown);
+
+    void submit(FetchRequest request, FetchCallback on_done);
+    std::future<FetchResult> fetch(FetchRequest request);
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Transfer {
+        FetchRequest request;
+        FetchResult result;
+        FetchCallback on_done;
+        Clock::time_point not_before; // Retry backoff
+        CURL* handle = nullptr;
+        curl_slist* headers = nullptr;
+    };
+
+    struct SiteState {
+        SitePolicy policy;
+        std::deque<std::unique_ptr<Transfer>> queue;
+        size_t in_flight = 0;
+    };
+
+    void run();
+    // Move every queued transfer its site allows into ready; returns when
+    // the next held-back one becomes eligible (Clock::time_point::max() if none)
+    Clock::time_point start_eligible(Clock::time_point now, std::vector<std::unique_ptr<Transfer>>& ready);
+    // Create the easy handle and add it to the multi handle; false (with
+    // result.curl_code set) if that fails
+    bool start(Transfer& transfer);
+    // Collect a completed transfer and queue it for delivery or a retry
+    void finish(CURL* handle, CURLcode code);
+    // Hand a finished transfer to its callback
+    void deliver(std::unique_ptr<Transfer> transfer);
+    // Return the transfer's handle to its site's pool (or free it when the pool is full)
+    void release(Transfer& transfer);
+    static void lock_share(CURL* handle, curl_lock_data data, curl_lock_access access, void* engine);
+    static void unlock_share(CURL* handle, curl_lock_data data, void* engine);
+    // Backoff before the next attempt, or zero when the result is final
+    std::chrono::milliseconds retry_delay(const Transfer& transfer) const;
+
+    CURLM* multi_ = nullptr;
+    CURLSH* share_ = nullptr;
+    std::mutex share_locks_[CURL_LOCK_DATA_LAST];
+    FetchEngineOptions options_;
+    RateLimiter limiter_;
+    size_t in_flight_ = 0;            // Engine thread only
+    std::map<CURL*, std::unique_ptr<Transfer>> running_; // Engine thread only
+    std::map<std::string, std::vector<CURL*>> idle_handles_; // Per site; engine thread only
+    std::set<std::string> cookie_files_; // Read into the share so far; engine thread only
+
+    std::mutex mutex_;                // Guards sites_, finished_ and stopping_
+    std::map<std::string, SiteState> sites_;
+    std::vector<std::unique_ptr<Transfer>> finished_; // Awaiting their callbacks
+    bool stopping_ = false;
+    std::thread loop_;
+};
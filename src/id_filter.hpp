@@ -0,0 +1,64 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Set of allowed job ids pushed down into a vector search, so excluded jobs
+// are skipped during the scan rather than filtered out of the top-k after
+// it. Stored as a bitmap over jobs.id in the byte layout of
+// faiss::IDSelectorBitmap (bit id & 7 of byte id >> 3), so FAISS can read it
+// without a copy.
+class IdFilter {
+public:
+    void add(int64_t id) {
+        if (id < 0) {
+            return;
+        }
+        size_t byte = static_cast<size_t>(id >> 3);
+        if (byte >= bits_.size()) {
+            bits_.resize(byte + 1, 0);
+        }
+        uint8_t mask = static_cast<uint8_t>(1u << (id & 7));
+        if (!(bits_[byte] & mask)) {
+            bits_[byte] |= mask;
+            count_++;
+        }
+    }
+
+    bool contains(int64_t id) const {
+        size_t byte = static_cast<size_t>(id >> 3);
+        return id >= 0 && byte < bits_.size() && ((bits_[byte] >> (id & 7)) & 1);
+    }
+
+    // Keep only ids that are also in other
+    void intersect(const IdFilter& other) {
+        bits_.resize(std::min(bits_.size(), other.bits_.size()));
+        count_ = 0;
+        for (size_t i = 0; i < bits_.size(); i++) {
+            bits_[i] &= other.bits_[i];
+            count_ += popcount(bits_[i]);
+        }
+    }
+
+    void clear() {
+        bits_.clear();
+        count_ = 0;
+    }
+
+    size_t count() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    const std::vector<uint8_t>& bitmap() const { return bits_; }
+
+private:
+    static size_t popcount(uint8_t byte) {
+        size_t n = 0;
+        for (; byte; byte &= static_cast<uint8_t>(byte - 1)) {
+            n++;
+        }
+        return n;
+    }
+
+    std::vector<uint8_t> bits_;
+    size_t count_ = 0;
+};
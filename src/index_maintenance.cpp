@@ -0,0 +1,238 @@
+#include "index_maintenance.hpp"
+#include "faiss_matcher.hpp"
+#include "sqlite_helper.hpp"
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <faiss/IndexIVF.h>
+#include <faiss/impl/IDSelector.h>
+#include <faiss/utils/distances.h>
+
+// Build a fresh index of options.type over the listed jobs
+static faiss::Index* build_index_for(sqlite3* db, const std::vector<int64_t>& job_ids,
+                                     const FaissIndexOptions& options) {
+    std::vector<int64_t> ids;
+    std::vector<float> vectors;
+    int dimension = 0;
+    if (!load_job_embeddings_by_id(db, job_ids, ids, vectors, dimension)) {
+        return nullptr;
+    }
+    if (ids.empty()) {
+        std::cerr << "[IndexMaintenance] No job embeddings to index\n";
+        return nullptr;
+    }
+    return build_faiss_index(ids, vectors, dimension, options);
+}
+
+bool sync_faiss_index(std::unique_ptr<faiss::Index>& index, sqlite3* db,
+                      const IndexUpdateOptions& options, IndexUpdateStats& stats) {
+    std::vector<int64_t> wanted;
+    if (!load_embedded_job_ids(db, wanted, options.max_age_days)) {
+        return false;
+    }
+
+    std::vector<int64_t> indexed = faiss_index_ids(index.get());
+
+    std::vector<int64_t> to_add;
+    std::vector<int64_t> to_remove;
+    std::set_difference(wanted.begin(), wanted.end(), indexed.begin(), indexed.end(),
+                        std::back_inserter(to_add));
+    std::set_difference(indexed.begin(), indexed.end(), wanted.begin(), wanted.end(),
+                        std::back_inserter(to_remove));
+
+    if (!to_remove.empty() && !faiss_index_supports_removal(index.get())) {
+        std::cout << "[IndexMaintenance] " << faiss_index_type(index.get())
+                  << " index cannot drop " << to_remove.size() << " jobs, rebuilding\n";
+        index.reset(build_index_for(db, wanted, options.index));
+        if (!index) {
+            return false;
+        }
+        stats.rebuilt = true;
+        stats.total = static_cast<size_t>(index->ntotal);
+        return true;
+    }
+
+    try {
+        if (!to_remove.empty()) {
+            faiss::IDSelectorBatch selector(to_remove.size(), to_remove.data());
+            stats.removed = index->remove_ids(selector);
+        }
+
+        // New jobs go into the existing IVF cells; the coarse quantizer is
+        // only retrained on a rebuild
+        if (!to_add.empty()) {
+            std::vector<int64_t> ids;
+            std::vector<float> vectors;
+            int dimension = index->d;
+            if (!load_job_embeddings_by_id(db, to_add, ids, vectors, dimension)) {
+                return false;
+            }
+            faiss::normalize_L2(dimension, ids.size(), vectors.data());
+            index->add_with_ids(ids.size(), vectors.data(), ids.data());
+            stats.added = ids.size();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[IndexMaintenance] Failed to update index: " << e.what() << "\n";
+        return false;
+    }
+
+    stats.total = static_cast<size_t>(index->ntotal);
+    return true;
+}
+
+// Dimension of the newest stored embedding, or 0 if there is none
+static int current_embedding_dimension(sqlite3* db) {
+    std::vector<int64_t> all_ids;
+    if (!load_embedded_job_ids(db, all_ids) || all_ids.empty()) {
+        return 0;
+    }
+
+    std::vector<int64_t> ids;
+    std::vector<float> vectors;
+    int dimension = 0;
+    load_job_embeddings_by_id(db, {all_ids.back()}, ids, vectors, dimension);
+    return dimension;
+}
+
+faiss::Index* update_faiss_index(sqlite3* db, const std::string& index_path,
+                                 const IndexUpdateOptions& options, IndexUpdateStats& stats) {
+    std::unique_ptr<faiss::Index> index;
+    if (std::filesystem::exists(index_path)) {
+        index.reset(load_faiss_index(index_path));
+    }
+
+    if (index && faiss_index_type(index.get()) != options.index.type) {
+        std::cout << "[IndexMaintenance] " << index_path << " holds a " << faiss_index_type(index.get())
+                  << " index, " << options.index.type << " requested, rebuilding\n";
+        index.reset();
+    }
+    if (index && index->d != current_embedding_dimension(db)) {
+        std::cout << "[IndexMaintenance] Index dimension " << index->d
+                  << " no longer matches the stored embeddings, rebuilding\n";
+        index.reset();
+    }
+
+    if (!index) {
+        std::vector<int64_t> wanted;
+        if (!load_embedded_job_ids(db, wanted, options.max_age_days)) {
+            return nullptr;
+        }
+        index.reset(build_index_for(db, wanted, options.index));
+        if (!index) {
+            return nullptr;
+        }
+        stats.rebuilt = true;
+    }
+
+    if (!sync_faiss_index(index, db, options, stats)) {
+        return nullptr;
+    }
+    set_search_parameters(index.get(), options.index);
+
+    if (stats.rebuilt || stats.added > 0 || stats.removed > 0) {
+        if (!save_faiss_index(index.get(), index_path)) {
+            return nullptr;
+        }
+    }
+
+    std::cout << "[IndexMaintenance] " << index_path << " (" << faiss_index_type(index.get()) << "): "
+              << (stats.rebuilt ? "rebuilt, " : "") << stats.added << " added, "
+              << stats.removed << " removed, " << stats.total << " jobs indexed\n";
+    return index.release();
+}
+
+bool report_faiss_recall(sqlite3* db, faiss::Index* index, const FaissIndexOptions& options,
+                         int k, size_t num_queries) {
+    std::vector<int64_t> ids;
+    std::vector<float> vectors;
+    int dimension = index->d;
+    if (!load_job_embeddings_by_id(db, faiss_index_ids(index), ids, vectors, dimension) || ids.empty()) {
+        std::cerr << "[Recall] No job embeddings to evaluate against\n";
+        return false;
+    }
+
+    // build_flat_index normalises vectors, so sampled rows are ready-made queries
+    std::unique_ptr<faiss::Index> flat(build_flat_index(ids, vectors, dimension));
+    if (!flat) {
+        return false;
+    }
+
+    size_t nq = std::min(num_queries, ids.size());
+    size_t step = ids.size() / nq;
+    std::vector<float> queries(nq * dimension);
+    for (size_t q = 0; q < nq; q++) {
+        std::copy_n(vectors.data() + q * step * dimension, dimension, queries.data() + q * dimension);
+    }
+
+    std::vector<faiss::idx_t> truth;
+    std::vector<float> scores;
+    search_top_matches_batch(flat.get(), queries, nq, k, truth, scores);
+
+    // Sweep the query-time knob of the index type; the configured value is included
+    std::string type = faiss_index_type(index);
+    std::vector<int> settings;
+    const char* knob = nullptr;
+    if (type == "ivf-flat" || type == "ivf-pq") {
+        knob = "nprobe";
+        int nlist = static_cast<int>(faiss::try_extract_index_ivf(index)->nlist);
+        for (int value = 1; value < nlist && value <= 1024; value *= 2) {
+            settings.push_back(value);
+        }
+        settings.push_back(nlist);
+        settings.push_back(std::min(options.nprobe, nlist));
+    } else if (type == "hnsw") {
+        knob = "efSearch";
+        for (int value = 16; value <= 1024; value *= 2) {
+            settings.push_back(value);
+        }
+        settings.push_back(options.ef_search);
+    } else {
+        settings.push_back(0);
+    }
+    std::sort(settings.begin(), settings.end());
+    settings.erase(std::unique(settings.begin(), settings.end()), settings.end());
+
+    std::cout << "[Recall] " << type << " index, " << ids.size() << " jobs, recall@" << k
+              << " against flat over " << nq << " sampled job vectors\n";
+
+    std::vector<faiss::idx_t> found;
+    for (int value : settings) {
+        FaissIndexOptions trial = options;
+        trial.nprobe = value;
+        trial.ef_search = value;
+        set_search_parameters(index, trial);
+
+        auto start = std::chrono::steady_clock::now();
+        search_top_matches_batch(index, queries, nq, k, found, scores);
+        double elapsed_ms = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start).count();
+
+        size_t hits = 0;
+        for (size_t q = 0; q < nq; q++) {
+            const faiss::idx_t* expected = truth.data() + q * k;
+            for (int i = 0; i < k; i++) {
+                faiss::idx_t id = found[q * k + i];
+                if (id >= 0 && std::find(expected, expected + k, id) != expected + k) {
+                    hits++;
+                }
+            }
+        }
+
+        std::cout << "[Recall]   ";
+        if (knob) {
+            std::cout << knob << "=" << std::left << std::setw(6) << value << std::right;
+        }
+        std::cout << " recall@" << k << " " << std::fixed << std::setprecision(4)
+                  << static_cast<double>(hits) / (nq * k) << "  " << std::setprecision(3)
+                  << elapsed_ms / nq << " ms/query\n";
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout.precision(6);
+    }
+
+    set_search_parameters(index, options);
+    return true;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <sqlite3.h>
+#include <faiss/Index.h>
+#include "faiss_options.hpp"
+
+struct IndexUpdateOptions {
+    int max_age_days = 0;     // Also drop jobs scraped longer ago than this; 0 keeps every job
+    FaissIndexOptions index;  // Index type for (re)builds and its query-time knobs
+};
+
+struct IndexUpdateStats {
+    size_t added = 0;
+    size_t removed = 0;
+    size_t total = 0;
+    bool rebuilt = false; // No usable index on disk, so it was built from scratch
+};
+
+// Bring index in line with the jobs table: add vectors for job ids it does
+// not hold yet and remove ids whose rows are gone (or expired). Only the new
+// rows' embeddings are read from SQLite. Index types that cannot delete
+// vectors (HNSW) are rebuilt in place when jobs have to go.
+bool sync_faiss_index(std::unique_ptr<faiss::Index>& index, sqlite3* db,
+                      const IndexUpdateOptions& options, IndexUpdateStats& stats);
+
+// Load the index at index_path, building it from SQLite when it is missing,
+// of another type than requested, or its dimension no longer matches the
+// stored embeddings, sync it, and persist it atomically if anything changed.
+// Returns nullptr on failure or when there are no job embeddings at all.
+faiss::Index* update_faiss_index(sqlite3* db, const std::string& index_path,
+                                 const IndexUpdateOptions& options, IndexUpdateStats& stats);
+
+// Print recall@k of index against an exact flat index over the same jobs,
+// with per-query latency, for a sweep of nprobe (IVF) or efSearch (HNSW)
+// values. Queries are sampled from the indexed job vectors. The index's own
+// search parameters are restored afterwards.
+bool report_faiss_recall(sqlite3* db, faiss::Index* index, const FaissIndexOptions& options,
+                         int k, size_t num_queries);
@@ -0,0 +1,117 @@
+#include "job_attributes.hpp"
+#include <algorithm>
+#include <cctype>
+#include <ctime>
+
+static std::string to_lower(const std::string& value) {
+    std::string lower = value;
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return lower;
+}
+
+// Pack the digits of "YYYY-MM-DD HH:MM:SS" into YYYYMMDDhhmmss so
+// timestamps compare as integers; -1 when there is no full date
+static int64_t pack_timestamp(const std::string& text) {
+    int64_t packed = 0;
+    int digits = 0;
+    for (char c : text) {
+        if (c >= '0' && c <= '9' && digits < 14) {
+            packed = packed * 10 + (c - '0');
+            digits++;
+        }
+    }
+    if (digits < 8) {
+        return -1;
+    }
+    for (; digits < 14; digits++) {
+        packed *= 10;
+    }
+    return packed;
+}
+
+// Local time max_age_days ago, packed like pack_timestamp
+static int64_t age_cutoff(int max_age_days) {
+    std::time_t cutoff = std::time(nullptr) - static_cast<std::time_t>(max_age_days) * 24 * 60 * 60;
+    std::tm local{};
+#ifdef _WIN32
+    localtime_s(&local, &cutoff);
+#else
+    localtime_r(&cutoff, &local);
+#endif
+    return (local.tm_year + 1900) * 10000000000LL + (local.tm_mon + 1) * 100000000LL +
+           local.tm_mday * 1000000LL + local.tm_hour * 10000LL + local.tm_min * 100LL + local.tm_sec;
+}
+
+uint32_t JobAttributes::intern(const std::string& value, std::vector<std::string>& dictionary,
+                               std::unordered_map<std::string, uint32_t>& lookup) {
+    std::string key = to_lower(value);
+    auto inserted = lookup.emplace(key, static_cast<uint32_t>(dictionary.size()));
+    if (inserted.second) {
+        dictionary.push_back(key);
+    }
+    return inserted.first->second;
+}
+
+void JobAttributes::add(int64_t id, const std::string& location, const std::string& source,
+                        const std::string& scraped_at) {
+    row_of_[id] = static_cast<uint32_t>(ids_.size());
+    ids_.push_back(id);
+    location_codes_.push_back(intern(location, locations_, location_lookup_));
+    source_codes_.push_back(intern(source, sources_, source_lookup_));
+    scraped_at_.push_back(pack_timestamp(scraped_at));
+}
+
+void JobAttributes::select(const AttributeFilter& filter, IdFilter& selected) const {
+    // Resolve each clause against the dictionaries once
+    std::vector<char> location_ok(locations_.size(), filter.locations.empty());
+    for (const std::string& wanted : filter.locations) {
+        std::string needle = to_lower(wanted);
+        for (size_t code = 0; code < locations_.size(); code++) {
+            if (locations_[code].find(needle) != std::string::npos) {
+                location_ok[code] = 1;
+            }
+        }
+    }
+
+    std::vector<char> source_ok(sources_.size(), filter.sources.empty());
+    for (const std::string& wanted : filter.sources) {
+        auto it = source_lookup_.find(to_lower(wanted));
+        if (it != source_lookup_.end()) {
+            source_ok[it->second] = 1;
+        }
+    }
+
+    int64_t cutoff = filter.max_age_days > 0 ? age_cutoff(filter.max_age_days) : -1;
+
+    for (size_t row = 0; row < ids_.size(); row++) {
+        if (!location_ok[location_codes_[row]] || !source_ok[source_codes_[row]]) {
+            continue;
+        }
+        if (cutoff >= 0 && scraped_at_[row] >= 0 && scraped_at_[row] < cutoff) {
+            continue;
+        }
+        selected.add(ids_[row]);
+    }
+}
+
+double JobAttributes::age_days(int64_t id, std::time_t now) const {
+    auto it = row_of_.find(id);
+    if (it == row_of_.end() || scraped_at_[it->second] < 0) {
+        return -1.0;
+    }
+    int64_t packed = scraped_at_[it->second];
+    std::tm local{};
+    local.tm_sec = static_cast<int>(packed % 100);
+    local.tm_min = static_cast<int>(packed / 100 % 100);
+    local.tm_hour = static_cast<int>(packed / 10000 % 100);
+    local.tm_mday = static_cast<int>(packed / 1000000 % 100);
+    local.tm_mon = static_cast<int>(packed / 100000000 % 100) - 1;
+    local.tm_year = static_cast<int>(packed / 10000000000LL) - 1900;
+    local.tm_isdst = -1;
+    std::time_t scraped = std::mktime(&local);
+    if (scraped == static_cast<std::time_t>(-1)) {
+        return -1.0;
+    }
+    return std::max(0.0, std::difftime(now, scraped) / (24.0 * 60 * 60));
+}
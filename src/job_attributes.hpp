@@ -0,0 +1,54 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "id_filter.hpp"
+
+// Restricts a match to jobs whose metadata passes every non-empty clause
+struct AttributeFilter {
+    std::vector<std::string> locations; // Case-insensitive substrings of jobs.location; any may match
+    std::vector<std::string> sources;   // jobs.source values, compared case-insensitively; any may match
+    int max_age_days = 0;               // Only jobs scraped within this many days; 0 disables
+
+    bool active() const { return !locations.empty() || !sources.empty() || max_age_days > 0; }
+};
+
+// Columnar copy of the jobs table columns that matches can be filtered on,
+// kept resident next to the vector index. Locations and sources are
+// dictionary-encoded, so a filter is resolved against the few distinct
+// values first and then applied to every job with one pass over small
+// integer columns.
+class JobAttributes {
+public:
+    // scraped_at is the "YYYY-MM-DD HH:MM:SS" text scrapper.cpp stores
+    void add(int64_t id, const std::string& location, const std::string& source,
+             const std::string& scraped_at);
+
+    // Add the ids of every job passing filter to selected. Jobs without a
+    // scraped_at never fail the age clause, as in index maintenance.
+    void select(const AttributeFilter& filter, IdFilter& selected) const;
+
+    // Days between the job's scraped_at and now, or -1 when the job or its
+    // date is unknown
+    double age_days(int64_t id, std::time_t now) const;
+
+    size_t size() const { return ids_.size(); }
+
+private:
+    // Dictionary code of the lowercased value, adding it when new
+    static uint32_t intern(const std::string& value, std::vector<std::string>& dictionary,
+                           std::unordered_map<std::string, uint32_t>& lookup);
+
+    std::vector<int64_t> ids_;
+    std::unordered_map<int64_t, uint32_t> row_of_;
+    std::vector<uint32_t> location_codes_;
+    std::vector<uint32_t> source_codes_;
+    std::vector<int64_t> scraped_at_; // YYYYMMDDhhmmss, or -1 when unknown
+    std::vector<std::string> locations_;
+    std::vector<std::string> sources_;
+    std::unordered_map<std::string, uint32_t> location_lookup_;
+    std::unordered_map<std::string, uint32_t> source_lookup_;
+};
@@ -5,15 +5,42 @@
 #include <cstdlib>
 #include <stdexcept>
 #include <algorithm>
+#include <memory>
 #include <sqlite3.h>
 #include "cv_job_matcher.hpp"
+#include "cv_embedder.hpp"
+#include "match_engine.hpp"
+#include "match_server.hpp"
+#include "sqlite_pool.hpp"
+#include "thread_pool.hpp"
+
+#ifdef ENABLE_FAISS
+#include "index_maintenance.hpp"
+#endif
+
+#include <cstdio>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 // Configuration constants
 const std::string DEFAULT_CV_FILE = "../data/sample_cv.txt";
 const std::string DEFAULT_CV_EMBEDDING_OUTPUT = "../output/embedding.json";
 const std::string DEFAULT_DB_PATH = "../data/jobs.db";
 const std::string DEFAULT_FAISS_INDEX_PATH = "../data/jobs_index.bin";
+const std::string DEFAULT_EMBEDDING_STORE_PATH = "../data/jobs_embeddings.bin";
 const int DEFAULT_TOP_K = 3;
+#ifdef _WIN32
+const std::string DEFAULT_SOCKET_PATH = "";
+#else
+const std::string DEFAULT_SOCKET_PATH = "/tmp/ai_job_matcher.sock";
+#endif
+const int DEFAULT_PORT = 8765;
+const std::string DEFAULT_BATCH_OUTPUT = "../output/batch_matches.json";
+const size_t RECALL_REPORT_QUERIES = 1000;
 
 void print_usage() {
     std::cout << "Usage: job_matcher [options]\n"
@@ -22,10 +49,51 @@ void print_usage() {
               << "  --output-file FILE   Path to save embedding output (default: " << DEFAULT_CV_EMBEDDING_OUTPUT << ")\n"
               << "  --db-path FILE       Path to SQLite database (default: " << DEFAULT_DB_PATH << ")\n"
               << "  --index-path FILE    Path to FAISS index file (default: " << DEFAULT_FAISS_INDEX_PATH << ")\n"
+              << "  --embedding-store FILE  Mapped binary job embeddings, rebuilt when stale (default: " << DEFAULT_EMBEDDING_STORE_PATH << ")\n"
+              << "  --no-embedding-store Read job embeddings straight from SQLite\n"
               << "  --top-k NUM          Number of top matches to show (default: " << DEFAULT_TOP_K << ")\n"
+              << "  --backend NAME       Search backend: exact, int8 or faiss (default: " << search_backend_name(default_search_backend()) << ")\n"
+              << "  --embedder NAME      CV embedder: native or python (default: native when COHERE_API_KEY is set)\n"
+              << "  --skip-filter        Embed CV text as-is instead of structuring it with Ollama first\n"
+              << "  --cv-sections        Also embed each section of a CV text and score jobs by the best-matching one\n"
+              << "  --cv-batch PATH      Match every CV (.json embedding or .txt text) in a directory or manifest file\n"
+              << "  --batch-output FILE  Where --cv-batch writes its results (default: " << DEFAULT_BATCH_OUTPUT << ")\n"
+              << "  --keyword-weight W   Weight of CV/job keyword relevance in the combined score (default: 0.4)\n"
+              << "  --keyword-prefilter  Search only jobs sharing a skill or title word with the CV text\n"
+              << "  --no-keyword-index   Rank by embedding similarity alone\n"
+              << "  --location TEXT      Only match jobs whose location contains TEXT (repeatable)\n"
+              << "  --source NAME        Only match jobs scraped from NAME (repeatable)\n"
+              << "  --scraped-within DAYS  Only match jobs scraped in the last DAYS days\n"
+              << "  --preview-only       Read only the first " << DESCRIPTION_PREVIEW_CHARS << " characters of each matched description\n"
+              << "  --rerank-depth NUM   Take NUM candidates from the index and rescore them exactly before ranking\n"
+              << "  --rerank NUM         Same as --rerank-depth\n"
+              << "  --recency-weight W   Score boost for a job scraped today, halving with age (default: 0)\n"
+              << "  --recency-half-life DAYS  Age at which the recency boost halves (default: 14)\n"
+              << "  --index-type TYPE    FAISS index: flat, ivf-flat, ivf-pq or hnsw (default: flat)\n"
+              << "  --nlist NUM          IVF cells when building an IVF index (default: about 4*sqrt(jobs))\n"
+              << "  --pq-m NUM           PQ sub-quantizers for ivf-pq (default: dimension/16)\n"
+              << "  --hnsw-m NUM         HNSW graph degree (default: 32)\n"
+              << "  --nprobe NUM         IVF cells scanned per query (default: 16)\n"
+              << "  --ef-search NUM      HNSW candidate list size per query (default: 64)\n"
+              << "  --recall-report      Print recall@k and latency of the FAISS index against flat search, then exit\n"
+              << "  --update-index       Add new jobs to and remove expired jobs from the FAISS index, then exit\n"
+              << "  --max-age-days NUM   Treat jobs scraped more than NUM days ago as expired in the FAISS index\n"
+              << "  --serve              Keep the job index resident and serve match requests\n"
+              << "  --socket PATH        Unix domain socket for --serve (default: " << DEFAULT_SOCKET_PATH << ")\n"
+              << "  --port NUM           Serve on 127.0.0.1:NUM instead of a Unix socket (default on Windows: " << DEFAULT_PORT << ")\n"
+              << "  --result-cache NUM   Match lists --serve keeps for repeated CVs (default: 1024, 0 disables)\n"
+              << "  --threads NUM        Worker threads for batch matching and --serve requests (default: all cores)\n"
               << "  --help               Show this help message\n";
 }
 
+static bool stdin_is_terminal() {
+#ifdef _WIN32
+    return _isatty(_fileno(stdin)) != 0;
+#else
+    return isatty(fileno(stdin)) != 0;
+#endif
+}
+
 int main(int argc, char* argv[]) {
     try {
         std::string cv_file = DEFAULT_CV_FILE;
@@ -33,6 +101,18 @@ int main(int argc, char* argv[]) {
         std::string db_path = DEFAULT_DB_PATH;
         std::string faiss_index_path = DEFAULT_FAISS_INDEX_PATH;
         int top_k = DEFAULT_TOP_K;
+        bool serve = false;
+        std::string socket_path = DEFAULT_SOCKET_PATH;
+        int port = DEFAULT_PORT;
+        EngineConfig engine_config;
+        engine_config.embedding_store_path = DEFAULT_EMBEDDING_STORE_PATH;
+        MatchOptions match_options;
+        std::string cv_batch;
+        std::string batch_output = DEFAULT_BATCH_OUTPUT;
+        EmbedderConfig embedder_config;
+        std::string embedder_name;
+        bool update_index = false;
+        bool recall_report = false;
         
         // Parse command line arguments
         for (int i = 1; i < argc; i++) {
@@ -49,12 +129,85 @@ int main(int argc, char* argv[]) {
                 db_path = argv[++i];
             } else if (arg == "--index-path" && i + 1 < argc) {
                 faiss_index_path = argv[++i];
+            } else if (arg == "--embedding-store" && i + 1 < argc) {
+                engine_config.embedding_store_path = argv[++i];
+            } else if (arg == "--no-embedding-store") {
+                engine_config.embedding_store_path.clear();
             } else if (arg == "--top-k" && i + 1 < argc) {
                 top_k = std::stoi(argv[++i]);
                 if (top_k <= 0) {
                     std::cerr << "Error: top-k must be positive\n";
                     return 1;
                 }
+            } else if (arg == "--cv-batch" && i + 1 < argc) {
+                cv_batch = argv[++i];
+            } else if (arg == "--batch-output" && i + 1 < argc) {
+                batch_output = argv[++i];
+            } else if (arg == "--backend" && i + 1 < argc) {
+                std::string name = argv[++i];
+                if (!parse_search_backend(name, engine_config.backend)) {
+                    std::cerr << "Error: unknown or unavailable search backend: " << name << "\n";
+                    return 1;
+                }
+            } else if (arg == "--embedder" && i + 1 < argc) {
+                embedder_name = argv[++i];
+            } else if (arg == "--skip-filter") {
+                embedder_config.filter_with_ollama = false;
+            } else if (arg == "--cv-sections") {
+                embedder_config.split_sections = true;
+            } else if (arg == "--index-type" && i + 1 < argc) {
+                engine_config.faiss_options.type = argv[++i];
+                if (!is_faiss_index_type(engine_config.faiss_options.type)) {
+                    std::cerr << "Error: unknown index type: " << engine_config.faiss_options.type << "\n";
+                    return 1;
+                }
+            } else if (arg == "--nlist" && i + 1 < argc) {
+                engine_config.faiss_options.nlist = std::stoi(argv[++i]);
+            } else if (arg == "--pq-m" && i + 1 < argc) {
+                engine_config.faiss_options.pq_m = std::stoi(argv[++i]);
+            } else if (arg == "--hnsw-m" && i + 1 < argc) {
+                engine_config.faiss_options.hnsw_m = std::stoi(argv[++i]);
+            } else if (arg == "--nprobe" && i + 1 < argc) {
+                engine_config.faiss_options.nprobe = std::stoi(argv[++i]);
+            } else if (arg == "--ef-search" && i + 1 < argc) {
+                engine_config.faiss_options.ef_search = std::stoi(argv[++i]);
+            } else if (arg == "--recall-report") {
+                recall_report = true;
+            } else if (arg == "--update-index") {
+                update_index = true;
+            } else if (arg == "--max-age-days" && i + 1 < argc) {
+                engine_config.max_job_age_days = std::stoi(argv[++i]);
+            } else if (arg == "--serve") {
+                serve = true;
+            } else if (arg == "--socket" && i + 1 < argc) {
+                socket_path = argv[++i];
+            } else if (arg == "--port" && i + 1 < argc) {
+                port = std::stoi(argv[++i]);
+                socket_path.clear();
+            } else if (arg == "--keyword-weight" && i + 1 < argc) {
+                match_options.keyword_weight = std::stof(argv[++i]);
+            } else if ((arg == "--rerank-depth" || arg == "--rerank") && i + 1 < argc) {
+                match_options.rerank_depth = std::stoi(argv[++i]);
+            } else if (arg == "--recency-weight" && i + 1 < argc) {
+                match_options.recency_weight = std::stof(argv[++i]);
+            } else if (arg == "--recency-half-life" && i + 1 < argc) {
+                match_options.recency_half_life_days = std::stof(argv[++i]);
+            } else if (arg == "--keyword-prefilter") {
+                match_options.keyword_prefilter = true;
+            } else if (arg == "--location" && i + 1 < argc) {
+                match_options.filter.locations.push_back(argv[++i]);
+            } else if (arg == "--source" && i + 1 < argc) {
+                match_options.filter.sources.push_back(argv[++i]);
+            } else if (arg == "--scraped-within" && i + 1 < argc) {
+                match_options.filter.max_age_days = std::stoi(argv[++i]);
+            } else if (arg == "--preview-only") {
+                match_options.preview_only = true;
+            } else if (arg == "--no-keyword-index") {
+                engine_config.keyword_index = false;
+            } else if (arg == "--result-cache" && i + 1 < argc) {
+                engine_config.result_cache_entries = static_cast<size_t>(std::max(0, std::stoi(argv[++i])));
+            } else if (arg == "--threads" && i + 1 < argc) {
+                engine_config.threads = static_cast<size_t>(std::max(0, std::stoi(argv[++i])));
             } else if (arg.substr(0, 2) == "--") {
                 std::cerr << "Unknown option: " << arg << "\n";
                 print_usage();
@@ -62,6 +215,84 @@ int main(int argc, char* argv[]) {
             }
         }
 
+        engine_config.db_path = db_path;
+        engine_config.faiss_index_path = faiss_index_path;
+        match_options.top_k = top_k;
+
+        if (update_index || recall_report) {
+#ifdef ENABLE_FAISS
+            ReadConnection connection;
+            if (!connection.open(db_path, ConnectionPoolOptions())) {
+                return 1;
+            }
+            sqlite3* db = connection.handle();
+            IndexUpdateOptions update_options;
+            update_options.max_age_days = engine_config.max_job_age_days;
+            update_options.index = engine_config.faiss_options;
+            IndexUpdateStats stats;
+            std::unique_ptr<faiss::Index> index(update_faiss_index(db, faiss_index_path, update_options, stats));
+            bool success = index != nullptr;
+            if (success && recall_report) {
+                // Measure at the candidate depth the matcher actually requests
+                int k = std::max(top_k * MatchOptions().candidate_multiplier, match_options.rerank_depth);
+                success = report_faiss_recall(db, index.get(), engine_config.faiss_options, k, RECALL_REPORT_QUERIES);
+            }
+            return success ? 0 : 1;
+#else
+            std::cerr << "Error: --update-index and --recall-report need a build with FAISS enabled\n";
+            return 1;
+#endif
+        }
+
+        // The daemon runs each request on one of its own workers, so the
+        // engine gets no pool of its own, only a connection per worker
+        size_t server_threads = engine_config.threads;
+        if (serve) {
+            size_t workers = server_threads > 0 ? server_threads : default_thread_count();
+            engine_config.threads = 1;
+            if (engine_config.db_connections == 0) {
+                engine_config.db_connections = workers;
+            }
+        }
+
+        MatchEngine engine(engine_config);
+
+        std::unique_ptr<Embedder> embedder = make_embedder(embedder_config, embedder_name);
+        if (!embedder) {
+            std::cerr << "Error: unknown embedder: " << embedder_name << "\n";
+            return 1;
+        }
+
+        if (serve) {
+            std::cout << "[Main] Starting matcher daemon...\n";
+            if (!engine.load()) {
+                throw std::runtime_error("[Main] Failed to load job index from " + db_path);
+            }
+            if (match_options.filter.active() && !engine.can_filter()) {
+                throw std::runtime_error("[Main] Job attributes unavailable; cannot apply --location, --source or --scraped-within");
+            }
+
+            ServerOptions server_options;
+            server_options.socket_path = socket_path;
+            server_options.port = port;
+            server_options.threads = server_threads;
+            server_options.match_options = match_options;
+            server_options.embedder = embedder.get();
+            server_options.embedder_config = embedder_config;
+            return run_match_server(engine, server_options);
+        }
+
+        if (!cv_batch.empty()) {
+            if (!engine.load()) {
+                throw std::runtime_error("[Main] Failed to load job index from " + db_path);
+            }
+            if (match_options.filter.active() && !engine.can_filter()) {
+                throw std::runtime_error("[Main] Job attributes unavailable; cannot apply --location, --source or --scraped-within");
+            }
+            match_cv_batch(cv_batch, engine, match_options, batch_output, embedder.get(), &embedder_config);
+            return 0;
+        }
+
         std::cout << "\n======================================\n";
         std::cout << "     AI Job Matching System\n";
         std::cout << "======================================\n\n";
@@ -72,28 +303,32 @@ int main(int argc, char* argv[]) {
         std::cout << "[Main] Database: " << db_path << "\n";
         std::cout << "[Main] FAISS index: " << faiss_index_path << "\n";
         std::cout << "[Main] Top-K matches: " << top_k << "\n";
+        std::cout << "[Main] Search backend: " << search_backend_name(engine_config.backend) << "\n";
 
-        // Step 1: Generate embedding for the CV using the Python script
-        std::cout << "\n[Main] Step 1: Generating CV embedding using Python script...\n";
-        
-#ifdef _WIN32
-        std::string cmd = "python ..\\src\\embedder.py --file \"" + cv_file + "\" --output \"" + output_file + "\"";
-        std::system("mkdir ..\\output 2>nul");
-#else
-        std::string cmd = "python ../src/embedder.py --file \"" + cv_file + "\" --output \"" + output_file + "\"";
-        std::system("mkdir -p ../output");
-#endif
-
-        int result = std::system(cmd.c_str());
-        if (result != 0) {
-            throw std::runtime_error("[Main] Python embedding script failed. Exit code: " + std::to_string(result));
+        // Step 1: Generate embedding for the CV
+        std::cout << "\n[Main] Step 1: Generating CV embedding (" << embedder->name() << " embedder)...\n";
+        std::vector<float> cv_embedding;
+        std::string cv_text;
+        size_t cv_sections = 1;
+        if (!embed_cv_file(*embedder, embedder_config, cv_file, cv_embedding, &cv_text, &cv_sections)) {
+            throw std::runtime_error("[Main] CV embedding failed");
+        }
+        // The embedding file is still written for tools that read it
+        if (!save_cv_embedding(cv_embedding, output_file, cv_sections)) {
+            throw std::runtime_error("[Main] Could not write CV embedding to " + output_file);
         }
         
         std::cout << "[Main] CV embedding generated successfully.\n";
         
         // Step 2: Match CV with jobs
         std::cout << "\n[Main] Step 2: Matching CV with jobs...\n";
-        match_cv_with_jobs(output_file, db_path, faiss_index_path, top_k);
+        if (!engine.load()) {
+            throw std::runtime_error("[Main] Failed to load job index from " + db_path);
+        }
+        if (match_options.filter.active() && !engine.can_filter()) {
+            throw std::runtime_error("[Main] Job attributes unavailable; cannot apply --location, --source or --scraped-within");
+        }
+        match_cv_with_jobs(output_file, engine, match_options, cv_text);
         
         std::cout << "\n[Main] Job matching process completed successfully.\n";
         
@@ -102,7 +337,10 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    std::cout << "\nPress Enter to exit...";
-    std::cin.get();
+    // Only pause for interactive runs; callers piping the output must not block
+    if (stdin_is_terminal()) {
+        std::cout << "\nPress Enter to exit...";
+        std::cin.get();
+    }
     return 0;
 }
\ No newline at end of file
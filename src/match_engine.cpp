@@ -0,0 +1,727 @@
+#include "match_engine.hpp"
+#include "distance_kernels.hpp"
+#include "sqlite_helper.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+#include <limits>
+
+#ifdef ENABLE_FAISS
+#include "faiss_matcher.hpp"
+#include "index_maintenance.hpp"
+#endif
+
+SearchBackend default_search_backend() {
+#ifdef ENABLE_FAISS
+    return SearchBackend::Faiss;
+#else
+    return SearchBackend::Exact;
+#endif
+}
+
+const char* search_backend_name(SearchBackend backend) {
+    switch (backend) {
+    case SearchBackend::Int8:
+        return "int8";
+    case SearchBackend::Faiss:
+        return "faiss";
+    default:
+        return "exact";
+    }
+}
+
+bool parse_search_backend(const std::string& name, SearchBackend& backend) {
+    if (name == "exact") {
+        backend = SearchBackend::Exact;
+        return true;
+    }
+    if (name == "int8") {
+        backend = SearchBackend::Int8;
+        return true;
+    }
+#ifdef ENABLE_FAISS
+    if (name == "faiss") {
+        backend = SearchBackend::Faiss;
+        return true;
+    }
+#endif
+    return false;
+}
+
+// Ranked jobs hydrated past top_k, standing in for rows deleted since indexing
+const size_t HYDRATION_SLACK = 4;
+
+// Buffers reused by every match on a thread, so steady-state queries do not
+// reallocate their query, candidate and hydration vectors
+struct MatchScratch {
+    std::vector<float> queries;
+    std::vector<size_t> row_begin;
+    std::vector<int64_t> ids;
+    std::vector<float> scores;
+    std::vector<std::vector<uint32_t>> terms;
+    IdFilter attribute_filter;
+    IdFilter filter;
+    std::vector<float> single_query;
+    std::vector<int64_t> single_ids;
+    std::vector<float> single_scores;
+    CandidateList candidates;
+    std::vector<size_t> order;
+    std::vector<int64_t> ranked_ids;
+    std::vector<int64_t> hydrate_ids;
+    std::vector<Job> hydrated;
+    std::vector<std::pair<float, int64_t>> merged;
+};
+static thread_local MatchScratch match_scratch;
+
+// Fold the top-k lists of one CV's rows into a single top-k of distinct
+// jobs, each scored by its best row (max-sim). A job in the max-sim top-k
+// is in the top-k of the row where it peaks, so the result is exact. Output
+// may alias the start of the input; unused slots get id -1.
+static void merge_section_candidates(const int64_t* ids, const float* scores, size_t rows, int k,
+                                     int64_t* out_ids, float* out_scores,
+                                     std::vector<std::pair<float, int64_t>>& merged) {
+    merged.clear();
+    for (size_t i = 0; i < rows * k; i++) {
+        if (ids[i] >= 0) {
+            merged.emplace_back(scores[i], ids[i]);
+        }
+    }
+    // Best score of each job first, then drop its other rows
+    std::sort(merged.begin(), merged.end(), [](const std::pair<float, int64_t>& a, const std::pair<float, int64_t>& b) {
+        return a.second != b.second ? a.second < b.second : a.first > b.first;
+    });
+    merged.erase(std::unique(merged.begin(), merged.end(),
+                             [](const std::pair<float, int64_t>& a, const std::pair<float, int64_t>& b) {
+                                 return a.second == b.second;
+                             }),
+                 merged.end());
+
+    size_t kept = std::min(merged.size(), static_cast<size_t>(k));
+    std::partial_sort(merged.begin(), merged.begin() + kept, merged.end(),
+                      [](const std::pair<float, int64_t>& a, const std::pair<float, int64_t>& b) {
+                          return a.first != b.first ? a.first > b.first : a.second < b.second;
+                      });
+    for (size_t i = 0; i < static_cast<size_t>(k); i++) {
+        out_ids[i] = i < kept ? merged[i].second : -1;
+        out_scores[i] = i < kept ? merged[i].first : 0.0f;
+    }
+}
+
+MatchEngine::MatchEngine(const EngineConfig& config) : config_(config) {}
+
+// Generations are unique across engines, not just within one
+static std::atomic<uint64_t> next_generation{1};
+
+static std::unique_ptr<SkillIndex> load_skill_index(sqlite3* db) {
+    std::vector<int64_t> ids;
+    std::vector<std::string> titles;
+    std::vector<std::vector<std::string>> skills;
+    if (!load_job_keywords(db, ids, titles, skills)) {
+        return nullptr;
+    }
+
+    auto index = std::make_unique<SkillIndex>();
+    for (size_t i = 0; i < ids.size(); i++) {
+        index->add(ids[i], titles[i], skills[i]);
+    }
+    index->finalize();
+    return index;
+}
+
+std::shared_ptr<const MappedEmbeddingStore> MatchEngine::open_embedding_store(sqlite3* db) {
+    const std::string& path = config_.embedding_store_path;
+
+    int64_t source_count = 0;
+    int64_t source_max_id = 0;
+    if (!query_embedding_watermark(db, source_count, source_max_id)) {
+        return nullptr;
+    }
+
+    auto store = std::make_shared<MappedEmbeddingStore>();
+    if (std::filesystem::exists(path) && store->open(path)) {
+        const EmbeddingStoreHeader& header = store->header();
+        if (header.source_count == source_count && header.source_max_id == source_max_id) {
+            return store;
+        }
+        std::cout << "[MatchEngine] Embedding store " << path << " is stale, rebuilding\n";
+    } else {
+        std::cout << "[MatchEngine] Building embedding store " << path << "\n";
+    }
+
+    // Release the old mapping before replacing the file underneath it
+    store = std::make_shared<MappedEmbeddingStore>();
+
+    std::vector<int64_t> ids;
+    std::vector<float> vectors;
+    int dimension = 0;
+    if (!load_job_embeddings(db, ids, vectors, dimension) || ids.empty()) {
+        return nullptr;
+    }
+    if (!write_embedding_store(path, ids, vectors, dimension, source_count, source_max_id)) {
+        return nullptr;
+    }
+    if (!store->open(path)) {
+        return nullptr;
+    }
+    return store;
+}
+
+void MatchEngine::count_jobs(std::vector<int64_t> labels) {
+    std::sort(labels.begin(), labels.end());
+    vector_count_ = labels.size();
+    job_count_ = 0;
+    max_chunks_ = 1;
+    for (size_t i = 0; i < labels.size();) {
+        size_t run = 1;
+        while (i + run < labels.size() && labels[i + run] == labels[i]) {
+            run++;
+        }
+        job_count_++;
+        max_chunks_ = std::max(max_chunks_, run);
+        i += run;
+    }
+}
+
+bool MatchEngine::load() {
+    auto start = std::chrono::steady_clock::now();
+
+    // Whatever index comes out of this load, cached results predate it
+    generation_ = next_generation++;
+    cache_.clear();
+    cache_.set_capacity(config_.result_cache_entries);
+
+#ifndef ENABLE_FAISS
+    // Without FAISS compiled in only the built-in scans are available
+    if (config_.backend == SearchBackend::Faiss) {
+        config_.backend = SearchBackend::Exact;
+    }
+#endif
+
+    size_t threads = config_.threads > 0 ? config_.threads : default_thread_count();
+    if (threads > 1) {
+        // The calling thread works alongside the pool in match_batch
+        workers_ = std::make_unique<ThreadPool>(threads - 1);
+    }
+
+    ConnectionPoolOptions pool_options;
+    pool_options.size = config_.db_connections > 0 ? config_.db_connections : threads;
+    if (!pool_.open(config_.db_path, pool_options)) {
+        return false;
+    }
+    ConnectionPool::Lease connection = pool_.acquire();
+    sqlite3* db = connection->handle();
+
+    if (config_.keyword_index) {
+        skill_index_ = load_skill_index(db);
+        if (skill_index_) {
+            std::cout << "[MatchEngine] Keyword index: " << skill_index_->term_count() << " terms over "
+                      << skill_index_->size() << " jobs\n";
+        } else {
+            std::cerr << "[MatchEngine] Keyword index unavailable, ranking by embedding similarity only\n";
+        }
+    }
+
+    attributes_ = std::make_unique<JobAttributes>();
+    if (!load_job_attributes(db, *attributes_)) {
+        std::cerr << "[MatchEngine] Job attributes unavailable, location/source/age filtered matches will be refused\n";
+        attributes_.reset();
+    }
+    keyword_fusion_ = std::make_unique<KeywordFusion>(skill_index_.get());
+    recency_boost_ = std::make_unique<RecencyBoost>(attributes_.get());
+    exact_rescorer_.reset();
+
+#ifdef ENABLE_FAISS
+    if (config_.backend == SearchBackend::Faiss && !config_.faiss_index_path.empty()) {
+        // Reuse the persisted index, applying only the jobs added or removed since it was saved
+        IndexUpdateOptions update_options;
+        update_options.max_age_days = config_.max_job_age_days;
+        update_options.index = config_.faiss_options;
+        IndexUpdateStats stats;
+        faiss_index_.reset(update_faiss_index(db, config_.faiss_index_path, update_options, stats));
+        if (faiss_index_) {
+            dimension_ = faiss_index_->d;
+            count_jobs(faiss_index_labels(faiss_index_.get()));
+            // Approximate indexes keep the store mapped for two-stage matches
+            if (faiss_index_type(faiss_index_.get()) != "flat" && !config_.embedding_store_path.empty()) {
+                if (std::shared_ptr<const MappedEmbeddingStore> store = open_embedding_store(db)) {
+                    exact_rescorer_ = std::make_unique<ExactRescorer>(store);
+                }
+            }
+            auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - start);
+            std::cout << "[MatchEngine] Indexed " << job_count_ << " jobs (dimension " << dimension_
+                      << ", faiss/" << faiss_index_type(faiss_index_.get()) << ", persisted index" << (exact_rescorer_ ? ", mapped store" : "") << ") in " << elapsed.count() << " ms\n";
+            return true;
+        }
+        std::cerr << "[MatchEngine] Persisted FAISS index unavailable, building in memory\n";
+    }
+#endif
+
+    std::shared_ptr<const MappedEmbeddingStore> store;
+    if (!config_.embedding_store_path.empty()) {
+        store = open_embedding_store(db);
+        if (!store) {
+            std::cerr << "[MatchEngine] Embedding store unavailable, reading embeddings from SQLite\n";
+        }
+    }
+
+    std::vector<int64_t> ids;
+    std::vector<float> vectors;
+    if (store) {
+        dimension_ = store->dimension();
+        count_jobs(std::vector<int64_t>(store->ids(), store->ids() + store->size()));
+    } else {
+        if (!load_job_embeddings(db, ids, vectors, dimension_)) {
+            return false;
+        }
+        count_jobs(ids);
+    }
+
+    if (job_count_ == 0) {
+        std::cerr << "[MatchEngine] No job embeddings available for matching\n";
+        return true;
+    }
+
+#ifdef ENABLE_FAISS
+    if (config_.backend == SearchBackend::Faiss) {
+        if (store) {
+            // FAISS keeps its own copy; unpack the padded rows
+            ids.assign(store->ids(), store->ids() + vector_count_);
+            vectors.resize(vector_count_ * dimension_);
+            for (size_t i = 0; i < vector_count_; i++) {
+                std::copy_n(store->vectors() + i * store->stride(), dimension_,
+                            vectors.data() + i * dimension_);
+            }
+        }
+        faiss_index_.reset(build_faiss_index(ids, vectors, dimension_, config_.faiss_options));
+        if (!faiss_index_) {
+            return false;
+        }
+    }
+#endif
+    if (config_.backend == SearchBackend::Exact) {
+        if (store) {
+            exact_index_ = std::make_unique<ExactIndex>(store);
+        } else {
+            exact_index_ = std::make_unique<ExactIndex>(dimension_);
+            exact_index_->add(ids, vectors);
+        }
+    }
+    if (config_.backend == SearchBackend::Int8) {
+        if (store) {
+            // The store stays mapped for exact_rescorer_
+            int8_index_ = std::make_unique<Int8Index>(store, true);
+        } else {
+            int8_index_ = std::make_unique<Int8Index>(dimension_);
+            int8_index_->add(ids, vectors);
+        }
+    }
+
+    // Only scores an approximate index produced need the exact second stage
+    bool approximate = config_.backend == SearchBackend::Int8 ||
+                       (config_.backend == SearchBackend::Faiss && config_.faiss_options.type != "flat");
+    if (store && approximate) {
+        exact_rescorer_ = std::make_unique<ExactRescorer>(store);
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << "[MatchEngine] Indexed " << job_count_ << " jobs (dimension " << dimension_
+              << ", " << search_backend_name(config_.backend);
+    if (config_.backend == SearchBackend::Exact || config_.backend == SearchBackend::Int8) {
+        std::cout << "/" << dot_product_isa();
+    }
+    if (int8_index_) {
+        size_t kib = int8_index_->memory_bytes() / 1024;
+        std::cout << ", " << (kib >= 1024 ? kib / 1024 : kib) << (kib >= 1024 ? " MB" : " KB") << " codes";
+    }
+#ifdef ENABLE_FAISS
+    if (faiss_index_) {
+        std::cout << "/" << faiss_index_type(faiss_index_.get());
+    }
+#endif
+    if (vector_count_ > job_count_) {
+        std::cout << ", " << vector_count_ << " chunk vectors";
+    }
+    if (store) {
+        std::cout << ", mapped store";
+    }
+    std::cout << ") in " << elapsed.count() << " ms\n";
+    return true;
+}
+
+bool MatchEngine::has_index() const {
+#ifdef ENABLE_FAISS
+    if (faiss_index_) {
+        return true;
+    }
+#endif
+    return exact_index_ != nullptr || int8_index_ != nullptr;
+}
+
+void MatchEngine::search(const std::vector<float>& queries, size_t nq, int k,
+                         std::vector<int64_t>& ids, std::vector<float>& scores,
+                         const IdFilter* filter) const {
+#ifdef ENABLE_FAISS
+    if (faiss_index_) {
+        if (max_chunks_ <= 1) {
+            search_top_matches_batch(faiss_index_.get(), queries, nq, k, ids, scores, filter);
+            return;
+        }
+        // FAISS cannot merge a job's chunks inside its heap. Each job fills
+        // at most max_chunks_ slots, so that many times k rows always hold k
+        // distinct jobs; keep the first (best) row of each.
+        static thread_local std::vector<int64_t> row_ids;
+        static thread_local std::vector<float> row_scores;
+        int fetch = static_cast<int>(std::min(static_cast<size_t>(k) * max_chunks_, vector_count_));
+        search_top_matches_batch(faiss_index_.get(), queries, nq, fetch, row_ids, row_scores, filter);
+        ids.assign(nq * k, -1);
+        scores.assign(nq * k, -std::numeric_limits<float>::infinity());
+        for (size_t q = 0; q < nq; q++) {
+            int64_t* out_ids = ids.data() + q * k;
+            float* out_scores = scores.data() + q * k;
+            int kept = 0;
+            for (int i = 0; i < fetch && kept < k; i++) {
+                int64_t id = row_ids[q * fetch + i];
+                if (id >= 0 && std::find(out_ids, out_ids + kept, id) == out_ids + kept) {
+                    out_ids[kept] = id;
+                    out_scores[kept] = row_scores[q * fetch + i];
+                    kept++;
+                }
+            }
+        }
+        return;
+    }
+#endif
+    if (int8_index_) {
+        search_top_matches_batch(int8_index_.get(), queries, nq, k, ids, scores, filter);
+        return;
+    }
+    search_top_matches_batch(exact_index_.get(), queries, nq, k, ids, scores, filter);
+}
+
+uint64_t MatchEngine::result_cache_key(const std::string& cv_text, const std::vector<float>& cv_embedding,
+                                      const MatchOptions& options, bool split_sections) const {
+    uint64_t key = hash_bytes(&generation_, sizeof(generation_));
+    key = hash_bytes(cv_text.data(), cv_text.size(), key);
+    uint64_t embedding_fingerprint = cv_embedding.empty() ? 0 : fingerprint_embedding(cv_embedding);
+    key = hash_bytes(&embedding_fingerprint, sizeof(embedding_fingerprint), key);
+
+    const float weights[] = {options.min_similarity, options.embedding_weight, options.keyword_weight,
+                             options.recency_weight, options.recency_half_life_days};
+    const int counts[] = {options.top_k, options.candidate_multiplier, options.keyword_prefilter ? 1 : 0,
+                          options.filter.max_age_days, options.preview_only ? 1 : 0, split_sections ? 1 : 0,
+                          options.rerank_depth};
+    key = hash_bytes(weights, sizeof(weights), key);
+    key = hash_bytes(counts, sizeof(counts), key);
+    // Separators keep ["ab"] and ["a", "b"] apart
+    for (const std::string& location : options.filter.locations) {
+        key = hash_bytes(location.c_str(), location.size() + 1, key);
+    }
+    key = hash_bytes("|", 1, key);
+    for (const std::string& source : options.filter.sources) {
+        key = hash_bytes(source.c_str(), source.size() + 1, key);
+    }
+    key = hash_bytes("|", 1, key);
+    for (const std::shared_ptr<const Reranker>& reranker : options.rerankers) {
+        key = hash_bytes(reranker->name(), std::strlen(reranker->name()) + 1, key);
+    }
+    return key;
+}
+
+std::vector<Job> MatchEngine::match(const std::vector<float>& cv_embedding,
+                                    const MatchOptions& options, const std::string& cv_text,
+                                    size_t sections, bool* ok) const {
+    if (ok) {
+        *ok = false;
+    }
+    if (!has_index()) {
+        return {};
+    }
+    if (sections == 0 || cv_embedding.size() != sections * dimension_) {
+        std::cerr << "[MatchEngine] CV embedding has " << cv_embedding.size() << " values but jobs use dimension "
+                  << dimension_ << " (" << sections << " section" << (sections == 1 ? "" : "s") << ")\n";
+        return {};
+    }
+    std::vector<std::string> cv_texts;
+    if (!cv_text.empty()) {
+        cv_texts.push_back(cv_text);
+    }
+    std::vector<size_t> section_counts(1, sections);
+    std::vector<bool> matched;
+    std::vector<Job> matches =
+        std::move(match_batch(cv_embedding, 1, options, cv_texts.empty() ? nullptr : &cv_texts, &section_counts,
+                              &matched).front());
+    if (ok) {
+        *ok = matched.front();
+    }
+    return matches;
+}
+
+void MatchEngine::match_range(const float* cv_embeddings, const size_t* sections, const std::string* cv_texts,
+                              size_t count, const MatchOptions& options, std::vector<Job>* results,
+                              unsigned char* ok) const {
+    MatchScratch& scratch = match_scratch;
+
+    // Query rows of each CV; a multi-vector CV has one per section
+    std::vector<size_t>& row_begin = scratch.row_begin;
+    row_begin.resize(count + 1);
+    row_begin[0] = 0;
+    for (size_t q = 0; q < count; q++) {
+        row_begin[q + 1] = row_begin[q] + (sections ? sections[q] : 1);
+    }
+    size_t rows = row_begin[count];
+
+    // Normalise each query so inner product equals cosine similarity
+    std::vector<float>& queries = scratch.queries;
+    queries.assign(cv_embeddings, cv_embeddings + rows * dimension_);
+    for (size_t q = 0; q < rows; q++) {
+        float* row = queries.data() + q * dimension_;
+        double norm = 0.0;
+        for (int d = 0; d < dimension_; d++) {
+            norm += static_cast<double>(row[d]) * row[d];
+        }
+        if (norm > 0.0) {
+            float inv = static_cast<float>(1.0 / std::sqrt(norm));
+            for (int d = 0; d < dimension_; d++) {
+                row[d] *= inv;
+            }
+        }
+    }
+
+    // Keyword terms of each CV whose text is known
+    std::vector<std::vector<uint32_t>>& terms = scratch.terms;
+    terms.resize(count);
+    for (size_t q = 0; q < count; q++) {
+        terms[q].clear();
+        if (skill_index_ && cv_texts && !cv_texts[q].empty()) {
+            terms[q] = skill_index_->query_terms(cv_texts[q]);
+        }
+    }
+
+    size_t searchable = job_count_;
+
+    // Attribute filters are resolved once for the whole batch and searched
+    // with, so a selective filter still yields a full top-k
+    const IdFilter* attribute_filter = nullptr;
+    if (options.filter.active()) {
+        scratch.attribute_filter.clear();
+        attributes_->select(options.filter, scratch.attribute_filter);
+        attribute_filter = &scratch.attribute_filter;
+        searchable = std::min(searchable, attribute_filter->count());
+        if (searchable == 0) {
+            return;
+        }
+    }
+
+    // The first stage only has to get the right jobs into the candidate
+    // list; with a rerank depth it casts a wider net for the second to rank
+    size_t first_stage = static_cast<size_t>(options.top_k) * options.candidate_multiplier;
+    first_stage = std::max(first_stage, static_cast<size_t>(std::max(options.rerank_depth, 0)));
+    int candidates_k = static_cast<int>(std::min(first_stage, searchable));
+
+    std::vector<int64_t>& ids = scratch.ids;
+    std::vector<float>& scores = scratch.scores;
+    if (!options.keyword_prefilter || !skill_index_ || !cv_texts) {
+        search(queries, rows, candidates_k, ids, scores, attribute_filter);
+    } else {
+        // Each CV searches only the jobs sharing one of its keywords, which
+        // needs a filter per query. Too small a keyword match set would
+        // starve the candidate list, so those CVs search every job the
+        // attribute filter allows.
+        ids.resize(rows * candidates_k);
+        scores.resize(rows * candidates_k);
+        for (size_t q = 0; q < count; q++) {
+            IdFilter& filter = scratch.filter;
+            filter.clear();
+            skill_index_->matching_jobs(terms[q], filter);
+            if (attribute_filter) {
+                filter.intersect(*attribute_filter);
+            }
+            const IdFilter* restrict_to = filter.count() >= static_cast<size_t>(candidates_k) ? &filter
+                                                                                              : attribute_filter;
+
+            size_t cv_rows = row_begin[q + 1] - row_begin[q];
+            scratch.single_query.assign(queries.begin() + row_begin[q] * dimension_,
+                                        queries.begin() + row_begin[q + 1] * dimension_);
+            search(scratch.single_query, cv_rows, candidates_k, scratch.single_ids, scratch.single_scores, restrict_to);
+            std::copy(scratch.single_ids.begin(), scratch.single_ids.end(), ids.begin() + row_begin[q] * candidates_k);
+            std::copy(scratch.single_scores.begin(), scratch.single_scores.end(),
+                      scores.begin() + row_begin[q] * candidates_k);
+        }
+    }
+
+    // Fold multi-vector CVs down to one candidate list each, in place
+    if (rows > count) {
+        for (size_t q = 0; q < count; q++) {
+            merge_section_candidates(ids.data() + row_begin[q] * candidates_k,
+                                     scores.data() + row_begin[q] * candidates_k, row_begin[q + 1] - row_begin[q],
+                                     candidates_k, ids.data() + q * candidates_k, scores.data() + q * candidates_k,
+                                     scratch.merged);
+        }
+    }
+
+    ConnectionPool::Lease connection = pool_.acquire();
+    CandidateList& candidates = scratch.candidates;
+    std::vector<size_t>& order = scratch.order;
+    std::vector<int64_t>& ranked_ids = scratch.ranked_ids;
+    for (size_t q = 0; q < count; q++) {
+        const int64_t* row_ids = ids.data() + q * candidates_k;
+        const float* row_scores = scores.data() + q * candidates_k;
+
+        candidates.clear();
+        for (int i = 0; i < candidates_k; i++) {
+            if (row_ids[i] >= 0) {
+                candidates.add(row_ids[i], row_scores[i]);
+            }
+        }
+
+        // Second stage: each re-ranker rescores the contiguous candidate buffers in turn
+        RerankQuery query;
+        query.rows = queries.data() + row_begin[q] * dimension_;
+        query.sections = row_begin[q + 1] - row_begin[q];
+        query.dimension = dimension_;
+        query.terms = &terms[q];
+        query.options = &options;
+        if (options.rerank_depth > 0 && exact_rescorer_) {
+            exact_rescorer_->rerank(query, candidates);
+        }
+        candidates.retain_similarity(options.min_similarity);
+        keyword_fusion_->rerank(query, candidates);
+        if (options.recency_weight != 0.0f) {
+            recency_boost_->rerank(query, candidates);
+        }
+        for (const std::shared_ptr<const Reranker>& reranker : options.rerankers) {
+            reranker->rerank(query, candidates);
+        }
+
+        // Rank by the combined score; candidates under the threshold are not hydrated
+        order.clear();
+        for (size_t i = 0; i < candidates.size(); i++) {
+            if (candidates.score[i] >= options.min_similarity) {
+                order.push_back(i);
+            }
+        }
+        std::stable_sort(order.begin(), order.end(),
+                         [&](size_t a, size_t b) { return candidates.score[a] > candidates.score[b]; });
+        ranked_ids.clear();
+        for (size_t i : order) {
+            ranked_ids.push_back(candidates.ids[i]);
+        }
+
+        // Hydrate the best top_k plus a little slack, going further down the
+        // ranking only when rows have gone missing
+        std::vector<Job>& matches = results[q];
+        matches.clear();
+        // One character past the preview tells print_matches it was cut
+        size_t description_chars = options.preview_only ? DESCRIPTION_PREVIEW_CHARS + 1 : 0;
+        size_t wanted = static_cast<size_t>(options.top_k);
+        size_t next = 0;
+        bool hydrated = true;
+        while (matches.size() < wanted && next < ranked_ids.size()) {
+            size_t take = std::min(ranked_ids.size() - next, wanted - matches.size() + HYDRATION_SLACK);
+            scratch.hydrate_ids.assign(ranked_ids.begin() + next, ranked_ids.begin() + next + take);
+            next += take;
+            if (!fetch_job_details_batch(*connection, scratch.hydrate_ids, scratch.hydrated, description_chars)) {
+                hydrated = false;
+                break;
+            }
+            matches.insert(matches.end(), std::make_move_iterator(scratch.hydrated.begin()),
+                           std::make_move_iterator(scratch.hydrated.end()));
+        }
+        if (!hydrated) {
+            matches.clear();
+            ok[q] = 0;
+            continue;
+        }
+        if (matches.size() > wanted) {
+            matches.resize(wanted);
+        }
+
+        // matches keeps the order of ranked_ids, minus rows that no longer exist
+        size_t p = 0;
+        for (Job& job : matches) {
+            while (ranked_ids[p] != job.id) {
+                p++;
+            }
+            size_t i = order[p];
+            job.embedding_similarity = candidates.similarity[i];
+            job.keyword_relevance = candidates.keyword[i];
+            job.similarity = candidates.score[i];
+        }
+    }
+}
+
+std::vector<std::vector<Job>> MatchEngine::match_batch(const std::vector<float>& cv_embeddings, size_t count,
+                                                       const MatchOptions& options,
+                                                       const std::vector<std::string>* cv_texts,
+                                                       const std::vector<size_t>* sections,
+                                                       std::vector<bool>* ok) const {
+    std::vector<std::vector<Job>> results(count);
+    if (ok) {
+        ok->assign(count, false);
+    }
+    if (!has_index() || count == 0) {
+        return results;
+    }
+
+    if (sections && sections->size() != count) {
+        std::cerr << "[MatchEngine] Expected " << count << " section counts, got " << sections->size() << "\n";
+        return results;
+    }
+    if (options.filter.active() && !can_filter()) {
+        // Unfiltered jobs would look like an answer to the filtered request
+        std::cerr << "[MatchEngine] Cannot apply the location/source/age filter without job attributes\n";
+        return results;
+    }
+    // First row of each CV
+    std::vector<size_t> row_begin(count + 1, 0);
+    for (size_t q = 0; q < count; q++) {
+        size_t cv_rows = sections ? (*sections)[q] : 1;
+        if (cv_rows == 0) {
+            std::cerr << "[MatchEngine] CV " << q << " has no embedding sections\n";
+            return results;
+        }
+        row_begin[q + 1] = row_begin[q] + cv_rows;
+    }
+    if (cv_embeddings.size() != row_begin[count] * dimension_) {
+        std::cerr << "[MatchEngine] Expected " << row_begin[count] << " CV embedding rows of dimension "
+                  << dimension_ << "\n";
+        return results;
+    }
+    if (cv_texts && cv_texts->size() != count) {
+        std::cerr << "[MatchEngine] Expected " << count << " CV texts, got " << cv_texts->size() << "\n";
+        return results;
+    }
+
+    // Chunks write disjoint bytes, which vector<bool> could not promise
+    std::vector<unsigned char> succeeded(count, 1);
+
+    // Split large batches across the workers; each chunk runs one search
+    size_t chunks = std::min(count, workers_ ? workers_->size() + 1 : 1);
+    size_t per_chunk = (count + chunks - 1) / chunks;
+    auto run_chunk = [&](size_t chunk) {
+        size_t begin = chunk * per_chunk;
+        size_t end = std::min(count, begin + per_chunk);
+        if (begin < end) {
+            match_range(cv_embeddings.data() + row_begin[begin] * dimension_,
+                        sections ? sections->data() + begin : nullptr, cv_texts ? cv_texts->data() + begin : nullptr,
+                        end - begin, options, results.data() + begin, succeeded.data() + begin);
+        }
+    };
+    if (chunks <= 1) {
+        run_chunk(0);
+    } else {
+        workers_->parallel_for(chunks, run_chunk);
+    }
+
+    if (ok) {
+        ok->assign(succeeded.begin(), succeeded.end());
+    }
+    return results;
+}
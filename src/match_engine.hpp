@@ -0,0 +1,171 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+#include <sqlite3.h>
+#include "cv_job_matcher.hpp"
+#include "embedding_store.hpp"
+#include "exact_index.hpp"
+#include "faiss_options.hpp"
+#include "quantized_index.hpp"
+#include "reranker.hpp"
+#include "result_cache.hpp"
+#include "id_filter.hpp"
+#include "job_attributes.hpp"
+#include "skill_index.hpp"
+#include "sqlite_pool.hpp"
+#include "thread_pool.hpp"
+
+#ifdef ENABLE_FAISS
+#include <faiss/Index.h>
+#endif
+
+// Which index answers the vector search
+enum class SearchBackend {
+    Exact, // Built-in SIMD brute-force scan (exact_index.hpp)
+    Int8,  // Same scan over int8-quantised vectors (quantized_index.hpp)
+    Faiss  // FAISS index (faiss_matcher.hpp); needs ENABLE_FAISS
+};
+
+// FAISS when compiled in, otherwise the exact scan
+SearchBackend default_search_backend();
+const char* search_backend_name(SearchBackend backend);
+// Parse "exact", "int8" or "faiss"; returns false for unknown or unavailable backends
+bool parse_search_backend(const std::string& name, SearchBackend& backend);
+
+// Scoring knobs; the defaults reproduce job_matcher.py
+struct MatchOptions {
+    int top_k = 3;
+    int candidate_multiplier = 3;  // Candidates fetched per requested match
+    float min_similarity = 0.25f;  // Applied to both raw and combined scores
+    float embedding_weight = 0.6f; // Weight of the embedding similarity in the combined score
+    float keyword_weight = 0.4f;   // Weight of the keyword relevance, when the CV text is known
+    bool keyword_prefilter = false; // Search only jobs sharing a skill or title word with the CV
+    AttributeFilter filter;        // Location/source/recency restriction, applied inside the search
+    bool preview_only = false;     // Hydrate only the description preview the CLI displays
+    // Two-stage retrieval: take this many candidates from the index search
+    // and rescore them at full precision from the mapped store before
+    // ranking. 0 ranks the top_k * candidate_multiplier search results as
+    // scored by the index.
+    int rerank_depth = 0;
+    float recency_weight = 0.0f;          // Score added to a job scraped just now; 0 disables
+    float recency_half_life_days = 14.0f; // Age at which the recency boost halves
+    // Extra stages run, in order, after the built-in exact, keyword and recency ones
+    std::vector<std::shared_ptr<const Reranker>> rerankers;
+};
+
+// Where the engine loads jobs from and how it searches them
+struct EngineConfig {
+    std::string db_path;
+    std::string faiss_index_path;     // Persisted FAISS index, kept in sync incrementally; empty builds in memory
+    std::string embedding_store_path; // Mapped embedding store; empty reads embeddings from SQLite
+    int max_job_age_days = 0;         // Persisted FAISS index drops jobs scraped longer ago; 0 keeps all
+    FaissIndexOptions faiss_options;  // FAISS index type and nprobe/efSearch
+    size_t threads = 0;               // Threads sharing batch matches; 0 uses every hardware thread
+    size_t db_connections = 0;        // Read-only SQLite connections; 0 opens one per thread
+    bool keyword_index = true;        // Index job skills and titles for hybrid keyword + embedding ranking
+    size_t result_cache_entries = 1024; // Match lists kept for repeated requests; 0 disables
+    SearchBackend backend = default_search_backend();
+};
+
+// In-process matcher: loads every job embedding once and answers top-k
+// queries against the resident index, hydrating results from SQLite.
+// After load() the index is read-only, so match() and match_batch() may be
+// called from any number of threads at once.
+class MatchEngine {
+public:
+    explicit MatchEngine(const EngineConfig& config);
+
+    MatchEngine(const MatchEngine&) = delete;
+    MatchEngine& operator=(const MatchEngine&) = delete;
+
+    // Open the read-only connection pool and build the index (or bring the persisted FAISS
+    // index up to date). Returns false on failure.
+    bool load();
+
+    // cv_text, when known, adds BM25 keyword relevance against job skills
+    // and titles to the ranking, as job_matcher.py did with the CV file.
+    // A multi-vector CV passes its sections rows back to back; each job is
+    // then scored by its best-matching section (max-sim). ok, if given, is
+    // set to false when the match failed (bad input, no index, unusable
+    // filter or a database error) rather than finding no jobs.
+    std::vector<Job> match(const std::vector<float>& cv_embedding, const MatchOptions& options,
+                           const std::string& cv_text = std::string(), size_t sections = 1,
+                           bool* ok = nullptr) const;
+
+    // Match count CV embeddings stored row-major in cv_embeddings with a
+    // single index search. Returns one result list per CV, in input order.
+    // Large batches are split across the engine's worker threads. cv_texts,
+    // if given, holds count texts (empty for CVs known only by embedding).
+    // sections, if given, holds the row count of each CV, whose rows are
+    // consecutive in cv_embeddings; otherwise every CV is one row. ok, if
+    // given, receives one flag per CV, false where matching it failed.
+    std::vector<std::vector<Job>> match_batch(const std::vector<float>& cv_embeddings, size_t count,
+                                              const MatchOptions& options,
+                                              const std::vector<std::string>* cv_texts = nullptr,
+                                              const std::vector<size_t>* sections = nullptr,
+                                              std::vector<bool>* ok = nullptr) const;
+
+    // Result cache key of a request: a hash of the CV text as submitted
+    // and/or of the quantised embedding (either may be empty), of the match
+    // options, and of the index generation. Text-only keys let a repeated
+    // CV skip embedding altogether; split_sections tells apart text that
+    // will be embedded per section.
+    uint64_t result_cache_key(const std::string& cv_text, const std::vector<float>& cv_embedding,
+                              const MatchOptions& options, bool split_sections = false) const;
+    bool cached_matches(uint64_t key, std::vector<Job>& matches) const { return cache_.get(key, matches); }
+    void cache_matches(uint64_t key, const std::vector<Job>& matches) const { cache_.put(key, matches); }
+    const ResultCache& result_cache() const { return cache_; }
+
+    // Bumped by every load(), so keys from an older index never match
+    uint64_t generation() const { return generation_; }
+    int dimension() const { return dimension_; }
+    // Distinct jobs indexed; a long job may hold several chunk vectors
+    size_t size() const { return job_count_; }
+    SearchBackend backend() const { return config_.backend; }
+    // Whether options.filter can be applied; match() refuses filtered
+    // requests (returning no jobs) when it cannot
+    bool can_filter() const { return attributes_ != nullptr; }
+
+private:
+    // Map the embedding store, rebuilding it from SQLite first when it is
+    // missing or older than the jobs table. Returns nullptr on failure.
+    std::shared_ptr<const MappedEmbeddingStore> open_embedding_store(sqlite3* db);
+    bool has_index() const;
+    // Match count row-major CV embeddings (with their section counts and
+    // texts, either of which may be nullptr), writing one list per CV to
+    // results and clearing ok[q] for each CV whose jobs could not be read
+    void match_range(const float* cv_embeddings, const size_t* sections, const std::string* cv_texts,
+                     size_t count, const MatchOptions& options, std::vector<Job>* results,
+                     unsigned char* ok) const;
+    // Count the distinct jobs among the index labels and the most chunk
+    // vectors any one of them has
+    void count_jobs(std::vector<int64_t> labels);
+    // Top-k distinct jobs over nq normalised row-major queries on whichever
+    // backend is loaded, skipping jobs outside filter when one is given
+    void search(const std::vector<float>& queries, size_t nq, int k,
+                std::vector<int64_t>& ids, std::vector<float>& scores,
+                const IdFilter* filter = nullptr) const;
+
+    EngineConfig config_;
+    // Leasing a connection is the only mutation match() makes
+    mutable ConnectionPool pool_;
+    std::unique_ptr<ThreadPool> workers_;
+    std::unique_ptr<ExactIndex> exact_index_;
+    std::unique_ptr<Int8Index> int8_index_;
+    std::unique_ptr<SkillIndex> skill_index_;
+    std::unique_ptr<JobAttributes> attributes_;
+    // Second-stage scorers; exact_rescorer_ only exists over an approximate index with a mapped store
+    std::unique_ptr<ExactRescorer> exact_rescorer_;
+    std::unique_ptr<KeywordFusion> keyword_fusion_;
+    std::unique_ptr<RecencyBoost> recency_boost_;
+    mutable ResultCache cache_;
+    uint64_t generation_ = 0;
+#ifdef ENABLE_FAISS
+    std::unique_ptr<faiss::Index> faiss_index_;
+#endif
+    int dimension_ = 0;
+    size_t job_count_ = 0;
+    size_t vector_count_ = 0;
+    size_t max_chunks_ = 1;
+};
@@ -0,0 +1,549 @@
+#include "match_server.hpp"
+#include "cv_job_matcher.hpp"
+#include "thread_pool.hpp"
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <deque>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using socket_t = SOCKET;
+#define CLOSE_SOCKET closesocket
+#define SHUT_RD SD_RECEIVE
+#define SHUT_RDWR SD_BOTH
+#define poll WSAPoll
+
+static int last_socket_error() {
+    return WSAGetLastError();
+}
+
+static bool accept_should_retry(int error) {
+    return error == WSAEINTR || error == WSAECONNABORTED || error == WSAECONNRESET || error == WSAEWOULDBLOCK;
+}
+
+static bool set_blocking(socket_t sock, bool blocking) {
+    u_long nonblocking = blocking ? 0 : 1;
+    return ioctlsocket(sock, FIONBIO, &nonblocking) == 0;
+}
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+using socket_t = int;
+const socket_t INVALID_SOCKET = -1;
+#define CLOSE_SOCKET close
+
+static int last_socket_error() {
+    return errno;
+}
+
+static bool accept_should_retry(int error) {
+    return error == EINTR || error == ECONNABORTED || error == EPROTO || error == EAGAIN || error == EWOULDBLOCK;
+}
+
+static bool set_blocking(socket_t sock, bool blocking) {
+    int flags = fcntl(sock, F_GETFL, 0);
+    if (flags < 0) {
+        return false;
+    }
+    flags = blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+    return fcntl(sock, F_SETFL, flags) == 0;
+}
+#endif
+
+using json = nlohmann::json;
+
+// Requests larger than this are rejected rather than buffered
+const size_t MAX_REQUEST_BYTES = 16 * 1024 * 1024;
+// Connections that send nothing for this long are closed
+const std::chrono::seconds IDLE_CONNECTION_TIMEOUT(300);
+// Longest the IO thread sleeps before checking for shutdown and idle connections
+const int POLL_INTERVAL_MS = 200;
+// Pause before accepting again when accept() runs out of descriptors or buffers
+const std::chrono::milliseconds ACCEPT_BACKOFF(250);
+
+static std::atomic<bool> stop_requested{false};
+static std::atomic<socket_t> listen_socket{INVALID_SOCKET};
+
+// Safe from a signal handler or any worker: only one caller gets the socket
+static void request_stop() {
+    stop_requested = true;
+    // Closing the listener stops new connections; the IO thread notices on its next wakeup
+    socket_t server = listen_socket.exchange(INVALID_SOCKET);
+    if (server != INVALID_SOCKET) {
+        shutdown(server, SHUT_RDWR);
+        CLOSE_SOCKET(server);
+    }
+}
+
+static void handle_stop_signal(int) {
+    request_stop();
+}
+
+static socket_t open_listener(const ServerOptions& options) {
+    socket_t sock = INVALID_SOCKET;
+
+#ifndef _WIN32
+    if (!options.socket_path.empty()) {
+        sockaddr_un addr{};
+        if (options.socket_path.size() >= sizeof(addr.sun_path)) {
+            std::cerr << "[MatchServer] Socket path too long: " << options.socket_path << "\n";
+            return INVALID_SOCKET;
+        }
+
+        sock = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (sock == INVALID_SOCKET) {
+            std::cerr << "[MatchServer] socket() failed: " << std::strerror(errno) << "\n";
+            return INVALID_SOCKET;
+        }
+
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, options.socket_path.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(options.socket_path.c_str());
+
+        if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(sock, 64) != 0) {
+            std::cerr << "[MatchServer] Cannot listen on " << options.socket_path << ": " << std::strerror(errno) << "\n";
+            CLOSE_SOCKET(sock);
+            return INVALID_SOCKET;
+        }
+
+        std::cout << "[MatchServer] Listening on unix:" << options.socket_path << "\n";
+        return sock;
+    }
+#endif
+
+    sock = socket(AF_INET, SOCK_STREAM, 0);
+    if (sock == INVALID_SOCKET) {
+        std::cerr << "[MatchServer] socket() failed\n";
+        return INVALID_SOCKET;
+    }
+
+    int reuse = 1;
+    setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    // Loopback only: the daemon is a local service for the web backend
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = htons(static_cast<unsigned short>(options.port));
+
+    if (bind(sock, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 || listen(sock, 64) != 0) {
+        std::cerr << "[MatchServer] Cannot listen on 127.0.0.1:" << options.port << "\n";
+        CLOSE_SOCKET(sock);
+        return INVALID_SOCKET;
+    }
+
+    std::cout << "[MatchServer] Listening on 127.0.0.1:" << options.port << "\n";
+    return sock;
+}
+
+static bool send_all(socket_t sock, const std::string& data) {
+    size_t sent = 0;
+    while (sent < data.size()) {
+        int n = send(sock, data.data() + sent, static_cast<int>(data.size() - sent), 0);
+        if (n <= 0) {
+            return false;
+        }
+        sent += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+static json error_response(const std::string& message) {
+    return json{{"status", "error"}, {"error", message}};
+}
+
+struct ServerState {
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    std::atomic<size_t> requests{0};
+};
+
+// A client connection. The IO thread reads it and queues complete request
+// lines; at most one worker at a time answers them, so responses leave in
+// request order. The socket closes when the last holder lets go.
+struct Connection {
+    explicit Connection(socket_t socket) : socket(socket) {}
+    ~Connection() { CLOSE_SOCKET(socket); }
+    Connection(const Connection&) = delete;
+    Connection& operator=(const Connection&) = delete;
+
+    const socket_t socket;
+    std::string pending; // IO thread only: bytes after the last newline
+
+    std::mutex mutex;
+    std::deque<std::string> lines;
+    std::chrono::steady_clock::time_point last_active = std::chrono::steady_clock::now();
+    bool too_large = false; // A request outgrew MAX_REQUEST_BYTES; answered with an error
+    bool busy = false;      // A worker is answering lines
+    bool broken = false;    // Nothing more will be read or answered
+};
+
+// A filter field may be one string or an array of them
+static std::vector<std::string> string_list(const json& value) {
+    if (value.is_array()) {
+        return value.get<std::vector<std::string>>();
+    }
+    return {value.get<std::string>()};
+}
+
+static json handle_request(MatchEngine& engine, const ServerOptions& options,
+                           ServerState& state, const json& request) {
+    std::string command = request.value("command", "match");
+
+    if (command == "ping") {
+        return json{{"status", "ok"}};
+    }
+    if (command == "stats") {
+        auto uptime = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now() - state.started);
+        return json{{"status", "ok"},
+                    {"jobs", engine.size()},
+                    {"dimension", engine.dimension()},
+                    {"requests", state.requests.load()},
+                    {"cache_entries", engine.result_cache().size()},
+                    {"cache_hits", engine.result_cache().hits()},
+                    {"cache_misses", engine.result_cache().misses()},
+                    {"uptime_seconds", uptime.count()}};
+    }
+    if (command == "shutdown") {
+        request_stop();
+        return json{{"status", "ok"}};
+    }
+    if (command != "match") {
+        return error_response("Unknown command: " + command);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    MatchOptions match_options = options.match_options;
+    match_options.top_k = request.value("top_k", match_options.top_k);
+    match_options.min_similarity = request.value("min_similarity", match_options.min_similarity);
+    match_options.keyword_weight = request.value("keyword_weight", match_options.keyword_weight);
+    match_options.keyword_prefilter = request.value("keyword_prefilter", match_options.keyword_prefilter);
+    match_options.preview_only = request.value("preview_only", match_options.preview_only);
+    match_options.rerank_depth = request.value("rerank_depth", match_options.rerank_depth);
+    match_options.recency_weight = request.value("recency_weight", match_options.recency_weight);
+    if (request.contains("filter")) {
+        const json& filter = request["filter"];
+        if (filter.contains("location")) {
+            match_options.filter.locations = string_list(filter["location"]);
+        }
+        if (filter.contains("source")) {
+            match_options.filter.sources = string_list(filter["source"]);
+        }
+        match_options.filter.max_age_days = filter.value("max_age_days", match_options.filter.max_age_days);
+    }
+    if (match_options.top_k <= 0) {
+        return error_response("top_k must be positive");
+    }
+    if (match_options.filter.active() && !engine.can_filter()) {
+        return error_response("Job attributes are unavailable, so location, source and age filters cannot be applied");
+    }
+
+    std::vector<float> embedding;
+    size_t sections = 1;
+    std::string cv_text;
+    bool precomputed = request.contains("embedding") || request.contains("cv_embedding_path");
+    if (precomputed) {
+        if (request.contains("embedding")) {
+            const json& value = request["embedding"];
+            if (!value.empty() && value.front().is_array()) {
+                // Multi-vector CV: one row per section
+                sections = value.size();
+                for (const json& row : value) {
+                    std::vector<float> values = row.get<std::vector<float>>();
+                    if (static_cast<int>(values.size()) != engine.dimension()) {
+                        return error_response("Every embedding section needs dimension " +
+                                              std::to_string(engine.dimension()));
+                    }
+                    embedding.insert(embedding.end(), values.begin(), values.end());
+                }
+            } else {
+                embedding = value.get<std::vector<float>>();
+            }
+        } else {
+            embedding = load_cv_embedding(request["cv_embedding_path"].get<std::string>(), engine.dimension(),
+                                          &sections);
+        }
+        // Text sent with a precomputed embedding only feeds keyword relevance
+        cv_text = request.value("cv_text", "");
+    } else if (request.contains("cv_file")) {
+        std::ifstream file(request["cv_file"].get<std::string>(), std::ios::binary);
+        if (!file.is_open()) {
+            return error_response("Cannot open CV file " + request["cv_file"].get<std::string>());
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        cv_text = buffer.str();
+    } else if (request.contains("cv_text")) {
+        cv_text = request["cv_text"].get<std::string>();
+    } else {
+        return error_response("Request needs one of embedding, cv_embedding_path, cv_file or cv_text");
+    }
+
+    // CV text is keyed as submitted, so a repeat skips filtering and embedding too
+    EmbedderConfig embedder_config = options.embedder_config;
+    embedder_config.split_sections = request.value("sections", embedder_config.split_sections);
+    uint64_t cache_key = engine.result_cache_key(cv_text, embedding, match_options,
+                                                 !precomputed && embedder_config.split_sections);
+    std::vector<Job> matches;
+    if (engine.cached_matches(cache_key, matches)) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start);
+        return json{{"status", "ok"},
+                    {"matches", matches},
+                    {"cached", true},
+                    {"elapsed_us", elapsed.count()}};
+    }
+
+    if (!precomputed) {
+        if (!options.embedder) {
+            return error_response("No embedder configured");
+        }
+        cv_text = filter_cv_text(cv_text, embedder_config);
+        std::vector<std::string> texts = cv_section_texts(cv_text, embedder_config);
+        std::vector<std::vector<float>> embeddings;
+        if (cv_text.empty() || !options.embedder->embed(texts, embeddings) || embeddings.size() != texts.size()) {
+            return error_response("CV embedding failed");
+        }
+        sections = embeddings.size();
+        for (const std::vector<float>& row : embeddings) {
+            embedding.insert(embedding.end(), row.begin(), row.end());
+        }
+    }
+
+    if (embedding.empty() || sections == 0) {
+        return error_response("Empty or unreadable CV embedding");
+    }
+    if (embedding.size() != sections * engine.dimension()) {
+        return error_response("CV embedding has dimension " + std::to_string(embedding.size() / sections) +
+                              ", index expects " + std::to_string(engine.dimension()));
+    }
+
+    // A failure (say the scraper holding the database) must not be cached as "no jobs"
+    bool matched = false;
+    matches = engine.match(embedding, match_options, cv_text, sections, &matched);
+    if (!matched) {
+        return error_response("Matching failed; see the server log");
+    }
+    engine.cache_matches(cache_key, matches);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    return json{{"status", "ok"},
+                {"matches", matches},
+                {"cached", false},
+                {"elapsed_us", elapsed.count()}};
+}
+
+// Worker task: answer the connection's queued lines in order until none are left
+static void answer_requests(MatchEngine& engine, const ServerOptions& options,
+                            ServerState& state, Connection& connection) {
+    while (true) {
+        std::string line;
+        {
+            std::lock_guard<std::mutex> lock(connection.mutex);
+            bool answered_all = connection.lines.empty() && !connection.too_large;
+            if (answered_all || connection.broken || stop_requested) {
+                connection.busy = false;
+                connection.last_active = std::chrono::steady_clock::now();
+                return;
+            }
+            if (connection.lines.empty()) {
+                connection.broken = true;
+            } else {
+                line = std::move(connection.lines.front());
+                connection.lines.pop_front();
+            }
+        }
+
+        json response;
+        if (line.empty()) {
+            // Only the too_large marker leaves line empty; blank lines are never queued
+            response = error_response("Request too large");
+        } else {
+            try {
+                response = handle_request(engine, options, state, json::parse(line));
+            } catch (const std::exception& e) {
+                response = error_response(e.what());
+            }
+            state.requests++;
+        }
+
+        if (!send_all(connection.socket, response.dump() + "\n")) {
+            std::lock_guard<std::mutex> lock(connection.mutex);
+            connection.broken = true;
+        }
+    }
+}
+
+// IO thread: read whatever the client sent and queue its complete lines.
+// Returns false once the connection should be dropped from the poll set.
+static bool read_requests(Connection& connection) {
+    char buffer[64 * 1024];
+    int n = recv(connection.socket, buffer, sizeof(buffer), 0);
+    if (n <= 0) {
+        return false;
+    }
+    connection.pending.append(buffer, static_cast<size_t>(n));
+
+    std::vector<std::string> lines;
+    size_t start = 0;
+    size_t newline;
+    while ((newline = connection.pending.find('\n', start)) != std::string::npos) {
+        std::string line = connection.pending.substr(start, newline - start);
+        start = newline + 1;
+        if (!line.empty() && line != "\r") {
+            lines.push_back(std::move(line));
+        }
+    }
+    connection.pending.erase(0, start);
+    bool too_large = connection.pending.size() > MAX_REQUEST_BYTES;
+
+    std::lock_guard<std::mutex> lock(connection.mutex);
+    connection.last_active = std::chrono::steady_clock::now();
+    for (std::string& line : lines) {
+        connection.lines.push_back(std::move(line));
+    }
+    connection.too_large = too_large;
+    return !too_large && !connection.broken;
+}
+
+int run_match_server(MatchEngine& engine, const ServerOptions& options) {
+#ifdef _WIN32
+    WSADATA wsa_data;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa_data) != 0) {
+        std::cerr << "[MatchServer] WSAStartup failed\n";
+        return 1;
+    }
+#else
+    // A client hanging up mid-response must not kill the daemon
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+    listen_socket = open_listener(options);
+    if (listen_socket == INVALID_SOCKET) {
+        return 1;
+    }
+    // A client that disconnects between poll() and accept() must not leave
+    // the IO thread blocked in accept()
+    set_blocking(listen_socket, false);
+
+    std::signal(SIGINT, handle_stop_signal);
+    std::signal(SIGTERM, handle_stop_signal);
+
+    ServerState state;
+    {
+        ThreadPool workers(options.threads);
+        std::cout << "[MatchServer] Ready: " << engine.size() << " jobs resident, "
+                  << workers.size() << " worker threads\n";
+
+        // Polled by this thread only; a worker answering a connection holds
+        // its own reference, so dropping one here never cuts off a response
+        std::map<socket_t, std::shared_ptr<Connection>> connections;
+        std::vector<pollfd> fds;
+        std::chrono::steady_clock::time_point accept_resume;
+
+        while (!stop_requested) {
+            socket_t server = listen_socket;
+            if (server == INVALID_SOCKET) {
+                break;
+            }
+
+            fds.clear();
+            // While backing off the listener stays in the set but is not watched
+            bool accepting = std::chrono::steady_clock::now() >= accept_resume;
+            fds.push_back(pollfd{server, static_cast<short>(accepting ? POLLIN : 0), 0});
+            for (const auto& entry : connections) {
+                fds.push_back(pollfd{entry.first, POLLIN, 0});
+            }
+            if (poll(fds.data(), static_cast<unsigned long>(fds.size()), POLL_INTERVAL_MS) < 0) {
+                continue;
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            for (size_t i = 1; i < fds.size(); i++) {
+                auto it = connections.find(fds[i].fd);
+                std::shared_ptr<Connection> connection = it->second;
+
+                bool keep = true;
+                if (fds[i].revents != 0) {
+                    keep = read_requests(*connection);
+                }
+
+                bool submit = false;
+                {
+                    std::lock_guard<std::mutex> lock(connection->mutex);
+                    bool waiting = !connection->lines.empty() || connection->too_large;
+                    if (waiting && !connection->busy && !connection->broken) {
+                        connection->busy = true;
+                        submit = true;
+                    }
+                    bool idle = !waiting && !connection->busy &&
+                                now - connection->last_active > IDLE_CONNECTION_TIMEOUT;
+                    keep = keep && !idle && !connection->broken;
+                }
+
+                if (submit) {
+                    workers.submit([&engine, &options, &state, connection] {
+                        answer_requests(engine, options, state, *connection);
+                    });
+                }
+                if (!keep) {
+                    connections.erase(it);
+                }
+            }
+
+            if (fds[0].revents & POLLIN) {
+                socket_t client = accept(server, nullptr, nullptr);
+                if (client != INVALID_SOCKET) {
+                    // Workers send with blocking writes; Windows hands out
+                    // sockets that inherit the listener's non-blocking mode
+                    set_blocking(client, true);
+                    connections[client] = std::make_shared<Connection>(client);
+                } else {
+                    int error = last_socket_error();
+                    if (!accept_should_retry(error) && !stop_requested) {
+                        // Out of descriptors or buffers: retrying at once
+                        // would spin, so leave the listener alone for a while
+                        std::cerr << "[MatchServer] accept() failed (error " << error << "), retrying in "
+                                  << ACCEPT_BACKOFF.count() << " ms\n";
+                        accept_resume = now + ACCEPT_BACKOFF;
+                    }
+                }
+            }
+        }
+
+        // Requests being answered still get their responses; queued ones
+        // are dropped, and each socket closes once its worker lets go
+        request_stop();
+        connections.clear();
+    }
+
+#ifdef _WIN32
+    WSACleanup();
+#else
+    if (!options.socket_path.empty()) {
+        unlink(options.socket_path.c_str());
+    }
+#endif
+
+    std::cout << "[MatchServer] Stopped after " << state.requests << " requests\n";
+    return 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <string>
+#include "cv_embedder.hpp"
+#include "match_engine.hpp"
+
+// Settings for the long-running matcher daemon (ai_job_matcher --serve)
+struct ServerOptions {
+    std::string socket_path;         // Unix domain socket path (POSIX only)
+    int port = 0;                    // Loopback TCP port, used when socket_path is empty
+    size_t threads = 0;              // Requests answered at once; 0 uses every hardware thread
+    MatchOptions match_options;      // Defaults for requests that do not override them
+    Embedder* embedder = nullptr;    // Resident embedder for cv_file / cv_text requests
+    EmbedderConfig embedder_config;
+};
+
+// Serve match requests until a shutdown request or SIGINT/SIGTERM arrives.
+//
+// Protocol: one JSON object per line in, one JSON object per line out.
+//   {"embedding": [...], "top_k": 5}        match a precomputed CV embedding
+//   {"cv_embedding_path": "..."}            match an embedding.json on disk
+//   {"cv_file": "..."}                      embed a CV text file, then match
+//   {"cv_text": "..."}                      embed CV text sent inline, then match
+// An "embedding" may also be a list of rows, one per CV section, and
+// "sections": true embeds cv_file / cv_text per section as well; jobs are
+// then scored by their best-matching section.
+// Any CV text (cv_text alongside an embedding, a cv_file, or inline text)
+// also feeds keyword relevance; "keyword_weight", "keyword_prefilter",
+// "rerank_depth", "recency_weight" and "preview_only" override the defaults
+// per request. "filter": {"location": "Paris",
+// "source": ["indeed", "linkedin"], "max_age_days": 7} restricts the search
+// itself; location matches substrings, and either field may be a list.
+//   {"command": "ping" | "stats" | "shutdown"}
+// Responses carry "status": "ok" with "matches", or "status": "error" with "error".
+// Repeated requests (same CV text or near-identical embedding, same options)
+// are answered from the engine's result cache and flagged "cached": true.
+// One IO thread reads every connection and hands each request to a worker,
+// so idle or slow clients hold no worker; requests on one connection are
+// answered in order. Connections silent for five minutes are closed.
+// Returns a process exit code.
+int run_match_server(MatchEngine& engine, const ServerOptions& options);
@@ -0,0 +1,641 @@
+// Benchmark of the matcher's search backends over a synthetic job catalogue.
+// Job vectors are drawn around random cluster centres, the way embeddings of
+// similar postings bunch together, and each job gets skills from a Zipf
+// distribution over a fixed vocabulary. Every backend is built over the same
+// catalogue and measured for build time, memory, single-query latency,
+// throughput across thread counts and recall@k against exact search.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "embedding_store.hpp"
+#include "exact_index.hpp"
+#include "faiss_options.hpp"
+#include "quantized_index.hpp"
+#include "reranker.hpp"
+#include "skill_index.hpp"
+#include "thread_pool.hpp"
+
+#ifdef ENABLE_FAISS
+#include <faiss/index_io.h>
+#include <faiss/impl/io.h>
+#include "faiss_matcher.hpp"
+#endif
+
+using json = nlohmann::json;
+
+// How far job vectors stray from their cluster centre, and queries from the
+// job they were derived from, relative to a unit vector
+const float CLUSTER_SPREAD = 0.6f;
+const float QUERY_NOISE = 0.3f;
+
+struct BenchConfig {
+    size_t jobs = 100000;
+    int dimension = 1024;
+    size_t clusters = 0;          // 0 picks about sqrt(jobs)
+    size_t queries = 1000;
+    int k = 10;
+    size_t skills = 2000;         // Skill vocabulary size
+    double skill_zipf = 1.1;      // Zipf exponent of skill popularity
+    int skills_per_job = 8;
+    int rerank = 64;              // Candidates int8-rerank rescores exactly
+    std::vector<size_t> threads;  // Empty sweeps 1, 2, 4, ... up to all cores
+    std::vector<std::string> backends;
+    FaissIndexOptions faiss_options;
+    uint32_t seed = 42;
+    std::string output_path = "matcher_bench.json";
+};
+
+struct Catalogue {
+    std::vector<int64_t> ids;
+    std::vector<float> vectors;   // jobs x dimension, normalised
+    std::vector<std::string> titles;
+    std::vector<std::vector<std::string>> skills;
+    std::vector<float> queries;   // queries x dimension, normalised
+    std::vector<std::string> query_texts;
+};
+
+// Top-k for nq row-major queries, laid out like ExactIndex::search
+using SearchFn = std::function<void(const float*, size_t, int, int64_t*, float*)>;
+
+struct Backend {
+    std::string name;
+    double build_ms = 0.0;
+    size_t memory_bytes = 0;      // Everything search touches, mapped files included
+    size_t mapped_bytes = 0;      // Part of memory_bytes that is a mapped fp32 store
+    SearchFn search;
+    std::shared_ptr<void> holder;  // Keeps the index alive as long as search
+};
+
+static void print_usage() {
+    BenchConfig defaults;
+    std::cout << "Usage: matcher_bench [options]\n"
+              << "Options:\n"
+              << "  --jobs NUM           Synthetic jobs in the catalogue (default: " << defaults.jobs << ")\n"
+              << "  --dim NUM            Embedding dimension (default: " << defaults.dimension << ")\n"
+              << "  --clusters NUM       Cluster centres the job vectors are drawn around (default: about sqrt(jobs))\n"
+              << "  --queries NUM        Queries per measurement (default: " << defaults.queries << ")\n"
+              << "  --top-k NUM          Results per query and the k of recall@k (default: " << defaults.k << ")\n"
+              << "  --skills NUM         Skill vocabulary size (default: " << defaults.skills << ")\n"
+              << "  --skill-zipf S       Zipf exponent of skill popularity (default: " << defaults.skill_zipf << ")\n"
+              << "  --skills-per-job NUM Skills drawn for each job (default: " << defaults.skills_per_job << ")\n"
+              << "  --threads LIST       Comma-separated thread counts for the throughput sweep (default: 1,2,4,... all cores)\n"
+              << "  --backends LIST      Comma-separated subset of exact, int8, int8-rerank"
+#ifdef ENABLE_FAISS
+              << ", flat, ivf-flat, ivf-pq, hnsw"
+#endif
+              << " (default: all)\n"
+              << "  --rerank NUM         Candidates int8-rerank rescores exactly (default: " << defaults.rerank << ")\n"
+              << "  --nlist NUM          IVF cells (default: about 4*sqrt(jobs))\n"
+              << "  --pq-m NUM           PQ sub-quantizers for ivf-pq (default: dimension/16)\n"
+              << "  --hnsw-m NUM         HNSW graph degree (default: 32)\n"
+              << "  --nprobe NUM         IVF cells scanned per query (default: 16)\n"
+              << "  --ef-search NUM      HNSW candidate list size per query (default: 64)\n"
+              << "  --seed NUM           Random seed of the catalogue (default: " << defaults.seed << ")\n"
+              << "  --output FILE        Where the JSON report is written (default: " << defaults.output_path << ")\n"
+              << "  --help               Show this help message\n";
+}
+
+static std::vector<std::string> split_list(const std::string& text) {
+    std::vector<std::string> items;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (!item.empty()) {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+static double elapsed_ms(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void normalize(float* vector, int dimension) {
+    double norm = 0.0;
+    for (int i = 0; i < dimension; i++) {
+        norm += static_cast<double>(vector[i]) * vector[i];
+    }
+    if (norm > 0.0) {
+        float scale = static_cast<float>(1.0 / std::sqrt(norm));
+        for (int i = 0; i < dimension; i++) {
+            vector[i] *= scale;
+        }
+    }
+}
+
+static Catalogue generate_catalogue(const BenchConfig& config) {
+    Catalogue catalogue;
+    std::mt19937_64 rng(config.seed);
+    std::normal_distribution<float> gaussian(0.0f, 1.0f);
+    size_t dimension = static_cast<size_t>(config.dimension);
+    size_t clusters = config.clusters;
+
+    std::vector<float> centres(clusters * dimension);
+    for (size_t c = 0; c < clusters; c++) {
+        for (size_t i = 0; i < dimension; i++) {
+            centres[c * dimension + i] = gaussian(rng);
+        }
+        normalize(centres.data() + c * dimension, config.dimension);
+    }
+
+    std::vector<double> popularity(config.skills);
+    for (size_t rank = 0; rank < config.skills; rank++) {
+        popularity[rank] = 1.0 / std::pow(static_cast<double>(rank + 1), config.skill_zipf);
+    }
+    std::discrete_distribution<size_t> skill_of(popularity.begin(), popularity.end());
+    std::uniform_int_distribution<size_t> cluster_of(0, clusters - 1);
+
+    float spread = CLUSTER_SPREAD / std::sqrt(static_cast<float>(dimension));
+    catalogue.ids.resize(config.jobs);
+    catalogue.vectors.resize(config.jobs * dimension);
+    catalogue.titles.resize(config.jobs);
+    catalogue.skills.resize(config.jobs);
+    for (size_t j = 0; j < config.jobs; j++) {
+        // Ids start at 1 like SQLite rowids
+        catalogue.ids[j] = static_cast<int64_t>(j) + 1;
+        size_t cluster = cluster_of(rng);
+        float* row = catalogue.vectors.data() + j * dimension;
+        for (size_t i = 0; i < dimension; i++) {
+            row[i] = centres[cluster * dimension + i] + spread * gaussian(rng);
+        }
+        normalize(row, config.dimension);
+        catalogue.titles[j] = "role" + std::to_string(cluster);
+        for (int s = 0; config.skills > 0 && s < config.skills_per_job; s++) {
+            catalogue.skills[j].push_back("skill" + std::to_string(skill_of(rng)));
+        }
+    }
+
+    // Each query is a perturbed job, so it has genuine near neighbours, and
+    // its text is that job's title and skills
+    std::uniform_int_distribution<size_t> job_of(0, config.jobs - 1);
+    float noise = QUERY_NOISE / std::sqrt(static_cast<float>(dimension));
+    catalogue.queries.resize(config.queries * dimension);
+    catalogue.query_texts.resize(config.queries);
+    for (size_t q = 0; q < config.queries; q++) {
+        size_t job = job_of(rng);
+        float* row = catalogue.queries.data() + q * dimension;
+        const float* source = catalogue.vectors.data() + job * dimension;
+        for (size_t i = 0; i < dimension; i++) {
+            row[i] = source[i] + noise * gaussian(rng);
+        }
+        normalize(row, config.dimension);
+        std::string text = catalogue.titles[job];
+        for (const std::string& skill : catalogue.skills[job]) {
+            text += " " + skill;
+        }
+        catalogue.query_texts[q] = text;
+    }
+    return catalogue;
+}
+
+#ifdef ENABLE_FAISS
+// Counts the bytes of a serialised index without keeping them
+struct CountingWriter : faiss::IOWriter {
+    size_t bytes = 0;
+    size_t operator()(const void*, size_t size, size_t nitems) override {
+        bytes += size * nitems;
+        return nitems;
+    }
+};
+#endif
+
+// Build the named backend over the catalogue; false when the name is unknown
+// or the build fails
+static bool build_backend(const std::string& name, const BenchConfig& config,
+                          const Catalogue& catalogue, const std::string& store_path, Backend& backend) {
+    backend.name = name;
+    std::vector<float> vectors = catalogue.vectors;
+    auto start = std::chrono::steady_clock::now();
+
+    if (name == "exact") {
+        auto index = std::make_shared<ExactIndex>(config.dimension);
+        index->add(catalogue.ids, vectors);
+        backend.build_ms = elapsed_ms(start);
+        backend.memory_bytes = index->memory_bytes();
+        backend.search = [index](const float* q, size_t nq, int k, int64_t* ids, float* scores) {
+            index->search(q, nq, k, ids, scores);
+        };
+        backend.holder = index;
+        return true;
+    }
+
+    if (name == "int8" || name == "int8-rerank") {
+        std::shared_ptr<Int8Index> index;
+        std::shared_ptr<ExactRescorer> rescorer;
+        int rerank = 0;
+        if (name == "int8") {
+            index = std::make_shared<Int8Index>(config.dimension);
+            index->add(catalogue.ids, vectors);
+        } else {
+            // Re-ranking reads the fp32 rows from a mapped store, as the
+            // matcher's ExactRescorer stage does, so the build includes
+            // writing one
+            int64_t max_id = catalogue.ids.empty() ? 0 : catalogue.ids.back();
+            auto store = std::make_shared<MappedEmbeddingStore>();
+            if (!write_embedding_store(store_path, catalogue.ids, vectors, config.dimension,
+                                       static_cast<int64_t>(catalogue.ids.size()), max_id) ||
+                !store->open(store_path)) {
+                return false;
+            }
+            index = std::make_shared<Int8Index>(store, true);
+            rescorer = std::make_shared<ExactRescorer>(store);
+            rerank = config.rerank;
+            backend.mapped_bytes = store->mapped_bytes();
+        }
+        backend.build_ms = elapsed_ms(start);
+        backend.memory_bytes = index->memory_bytes() + backend.mapped_bytes;
+        int dimension = config.dimension;
+        backend.search = [index, rescorer, rerank, dimension](const float* q, size_t nq, int k, int64_t* ids,
+                                                              float* scores) {
+            if (!rescorer) {
+                index->search(q, nq, k, ids, scores);
+                return;
+            }
+            // Take the deeper candidate list, rescore it exactly and keep the best k
+            int depth = std::max(rerank, k);
+            std::vector<int64_t> candidate_ids(nq * depth);
+            std::vector<float> candidate_scores(nq * depth);
+            index->search(q, nq, depth, candidate_ids.data(), candidate_scores.data());
+            CandidateList candidates;
+            std::vector<size_t> order;
+            for (size_t i = 0; i < nq; i++) {
+                candidates.clear();
+                for (int c = 0; c < depth; c++) {
+                    if (candidate_ids[i * depth + c] >= 0) {
+                        candidates.add(candidate_ids[i * depth + c], candidate_scores[i * depth + c]);
+                    }
+                }
+                RerankQuery query;
+                query.rows = q + i * dimension;
+                query.dimension = dimension;
+                rescorer->rerank(query, candidates);
+
+                order.resize(candidates.size());
+                for (size_t c = 0; c < order.size(); c++) {
+                    order[c] = c;
+                }
+                std::stable_sort(order.begin(), order.end(),
+                                 [&](size_t a, size_t b) { return candidates.score[a] > candidates.score[b]; });
+                for (int c = 0; c < k; c++) {
+                    bool found = static_cast<size_t>(c) < order.size();
+                    ids[i * k + c] = found ? candidates.ids[order[c]] : -1;
+                    scores[i * k + c] = found ? candidates.score[order[c]] : -std::numeric_limits<float>::infinity();
+                }
+            }
+        };
+        backend.holder = index;
+        return true;
+    }
+
+#ifdef ENABLE_FAISS
+    if (is_faiss_index_type(name)) {
+        FaissIndexOptions options = config.faiss_options;
+        options.type = name;
+        std::shared_ptr<faiss::Index> index(build_faiss_index(catalogue.ids, vectors, config.dimension, options));
+        if (!index) {
+            return false;
+        }
+        set_search_parameters(index.get(), options);
+        backend.build_ms = elapsed_ms(start);
+        CountingWriter writer;
+        faiss::write_index(index.get(), &writer);
+        backend.memory_bytes = writer.bytes;
+        backend.search = [index](const float* q, size_t nq, int k, int64_t* ids, float* scores) {
+            index->search(static_cast<faiss::idx_t>(nq), q, k, scores, ids);
+        };
+        backend.holder = index;
+        return true;
+    }
+#endif
+
+    std::cerr << "[Bench] Unknown backend: " << name << "\n";
+    return false;
+}
+
+// Value at fraction p of an ascending list
+static double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+    size_t rank = std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()));
+    return sorted[rank];
+}
+
+static json latency_summary(std::vector<double> micros) {
+    std::sort(micros.begin(), micros.end());
+    double total = 0.0;
+    for (double value : micros) {
+        total += value;
+    }
+    return json{
+        {"mean_us", micros.empty() ? 0.0 : total / micros.size()},
+        {"p50_us", percentile(micros, 0.50)},
+        {"p99_us", percentile(micros, 0.99)}
+    };
+}
+
+// Fraction of the exact top-k each query's results recovered
+static double recall_at_k(const std::vector<int64_t>& truth, const std::vector<int64_t>& found,
+                          size_t nq, int k) {
+    size_t hits = 0;
+    for (size_t q = 0; q < nq; q++) {
+        const int64_t* expected = truth.data() + q * k;
+        for (int i = 0; i < k; i++) {
+            int64_t id = found[q * k + i];
+            if (id >= 0 && std::find(expected, expected + k, id) != expected + k) {
+                hits++;
+            }
+        }
+    }
+    return nq == 0 ? 0.0 : static_cast<double>(hits) / (nq * k);
+}
+
+static json run_backend(const Backend& backend, const BenchConfig& config, const Catalogue& catalogue,
+                        const std::vector<int64_t>& truth) {
+    size_t nq = config.queries;
+    int k = config.k;
+    size_t dimension = static_cast<size_t>(config.dimension);
+    std::vector<int64_t> ids(nq * k);
+    std::vector<float> scores(nq * k);
+
+    // One query at a time on this thread: the latency a single request sees
+    std::vector<double> micros(nq);
+    for (size_t q = 0; q < nq; q++) {
+        auto start = std::chrono::steady_clock::now();
+        backend.search(catalogue.queries.data() + q * dimension, 1, k, ids.data() + q * k, scores.data() + q * k);
+        micros[q] = elapsed_ms(start) * 1000.0;
+    }
+    double recall = recall_at_k(truth, ids, nq, k);
+
+    // Independent single-query requests spread over t threads, as the
+    // daemon serves them
+    json qps = json::object();
+    for (size_t threads : config.threads) {
+        std::unique_ptr<ThreadPool> pool;
+        if (threads > 1) {
+            pool.reset(new ThreadPool(threads - 1));
+        }
+        auto query = [&](size_t q) {
+            static thread_local std::vector<int64_t> local_ids;
+            static thread_local std::vector<float> local_scores;
+            local_ids.resize(k);
+            local_scores.resize(k);
+            backend.search(catalogue.queries.data() + q * dimension, 1, k, local_ids.data(), local_scores.data());
+        };
+        auto start = std::chrono::steady_clock::now();
+        if (pool) {
+            pool->parallel_for(nq, query);
+        } else {
+            for (size_t q = 0; q < nq; q++) {
+                query(q);
+            }
+        }
+        double ms = elapsed_ms(start);
+        qps[std::to_string(threads)] = ms > 0.0 ? nq * 1000.0 / ms : 0.0;
+    }
+
+    // Every query in one call, as a --cv-batch run issues them
+    auto start = std::chrono::steady_clock::now();
+    backend.search(catalogue.queries.data(), nq, k, ids.data(), scores.data());
+    double batch_ms = elapsed_ms(start);
+
+    json result = {
+        {"backend", backend.name},
+        {"build_ms", backend.build_ms},
+        {"memory_bytes", backend.memory_bytes},
+        {"mapped_bytes", backend.mapped_bytes},
+        {"latency", latency_summary(micros)},
+        {"qps", qps},
+        {"batch_qps", batch_ms > 0.0 ? nq * 1000.0 / batch_ms : 0.0},
+        {"recall_at_k", recall}
+    };
+
+    std::cout << "[Bench] " << std::left << std::setw(12) << backend.name << std::right << std::fixed
+              << std::setprecision(1) << " build " << backend.build_ms << " ms, "
+              << backend.memory_bytes / (1024.0 * 1024.0) << " MiB, p50 "
+              << result["latency"]["p50_us"].get<double>() << " us, p99 "
+              << result["latency"]["p99_us"].get<double>() << " us, recall@" << k << " "
+              << std::setprecision(4) << recall << std::setprecision(0);
+    for (size_t threads : config.threads) {
+        std::cout << ", " << threads << "t " << qps[std::to_string(threads)].get<double>() << " qps";
+    }
+    std::cout << "\n";
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout.precision(6);
+    return result;
+}
+
+// Cost of the keyword side under the configured skill distribution: index
+// build, BM25 scoring of each query's exact top-k and the skill prefilter
+static json run_keyword_bench(const BenchConfig& config, const Catalogue& catalogue,
+                              const std::vector<int64_t>& truth) {
+    auto start = std::chrono::steady_clock::now();
+    SkillIndex index;
+    for (size_t j = 0; j < catalogue.ids.size(); j++) {
+        index.add(catalogue.ids[j], catalogue.titles[j], catalogue.skills[j]);
+    }
+    index.finalize();
+    double build_ms = elapsed_ms(start);
+
+    size_t nq = config.queries;
+    std::vector<double> score_micros(nq);
+    std::vector<double> prefilter_micros(nq);
+    std::vector<float> scores(config.k);
+    double selected = 0.0;
+    for (size_t q = 0; q < nq; q++) {
+        std::vector<uint32_t> terms = index.query_terms(catalogue.query_texts[q]);
+
+        auto score_start = std::chrono::steady_clock::now();
+        index.score(terms, truth.data() + q * config.k, config.k, scores.data());
+        score_micros[q] = elapsed_ms(score_start) * 1000.0;
+
+        auto prefilter_start = std::chrono::steady_clock::now();
+        IdFilter filter;
+        index.matching_jobs(terms, filter);
+        prefilter_micros[q] = elapsed_ms(prefilter_start) * 1000.0;
+        selected += filter.count();
+    }
+    double selectivity = nq == 0 || index.size() == 0 ? 0.0 : selected / nq / index.size();
+
+    std::cout << "[Bench] keywords     build " << std::fixed << std::setprecision(1) << build_ms << " ms, "
+              << index.term_count() << " terms, prefilter keeps " << std::setprecision(2)
+              << selectivity * 100.0 << "% of jobs\n";
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout.precision(6);
+
+    return json{
+        {"build_ms", build_ms},
+        {"terms", index.term_count()},
+        {"score", latency_summary(score_micros)},
+        {"prefilter", latency_summary(prefilter_micros)},
+        {"prefilter_selectivity", selectivity}
+    };
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        BenchConfig config;
+
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+
+            if (arg == "--help") {
+                print_usage();
+                return 0;
+            } else if (arg == "--jobs" && i + 1 < argc) {
+                config.jobs = std::stoul(argv[++i]);
+            } else if (arg == "--dim" && i + 1 < argc) {
+                config.dimension = std::stoi(argv[++i]);
+            } else if (arg == "--clusters" && i + 1 < argc) {
+                config.clusters = std::stoul(argv[++i]);
+            } else if (arg == "--queries" && i + 1 < argc) {
+                config.queries = std::stoul(argv[++i]);
+            } else if (arg == "--top-k" && i + 1 < argc) {
+                config.k = std::stoi(argv[++i]);
+            } else if (arg == "--skills" && i + 1 < argc) {
+                config.skills = std::stoul(argv[++i]);
+            } else if (arg == "--skill-zipf" && i + 1 < argc) {
+                config.skill_zipf = std::stod(argv[++i]);
+            } else if (arg == "--skills-per-job" && i + 1 < argc) {
+                config.skills_per_job = std::stoi(argv[++i]);
+            } else if (arg == "--threads" && i + 1 < argc) {
+                for (const std::string& item : split_list(argv[++i])) {
+                    config.threads.push_back(std::stoul(item));
+                }
+            } else if (arg == "--backends" && i + 1 < argc) {
+                config.backends = split_list(argv[++i]);
+            } else if (arg == "--rerank" && i + 1 < argc) {
+                config.rerank = std::stoi(argv[++i]);
+            } else if (arg == "--nlist" && i + 1 < argc) {
+                config.faiss_options.nlist = std::stoi(argv[++i]);
+            } else if (arg == "--pq-m" && i + 1 < argc) {
+                config.faiss_options.pq_m = std::stoi(argv[++i]);
+            } else if (arg == "--hnsw-m" && i + 1 < argc) {
+                config.faiss_options.hnsw_m = std::stoi(argv[++i]);
+            } else if (arg == "--nprobe" && i + 1 < argc) {
+                config.faiss_options.nprobe = std::stoi(argv[++i]);
+            } else if (arg == "--ef-search" && i + 1 < argc) {
+                config.faiss_options.ef_search = std::stoi(argv[++i]);
+            } else if (arg == "--seed" && i + 1 < argc) {
+                config.seed = static_cast<uint32_t>(std::stoul(argv[++i]));
+            } else if (arg == "--output" && i + 1 < argc) {
+                config.output_path = argv[++i];
+            } else {
+                std::cerr << "Unknown option: " << arg << "\n";
+                print_usage();
+                return 1;
+            }
+        }
+
+        if (config.jobs == 0 || config.dimension <= 0 || config.queries == 0 || config.k <= 0) {
+            std::cerr << "Error: --jobs, --dim, --queries and --top-k must be positive\n";
+            return 1;
+        }
+        if (config.k > static_cast<int>(config.jobs)) {
+            config.k = static_cast<int>(config.jobs);
+        }
+        if (config.clusters == 0) {
+            config.clusters = std::max<size_t>(1, static_cast<size_t>(std::sqrt(static_cast<double>(config.jobs))));
+        }
+        if (config.threads.empty()) {
+            size_t cores = default_thread_count();
+            for (size_t threads = 1; threads < cores; threads *= 2) {
+                config.threads.push_back(threads);
+            }
+            config.threads.push_back(cores);
+        }
+        for (size_t threads : config.threads) {
+            if (threads == 0) {
+                std::cerr << "Error: thread counts must be positive\n";
+                return 1;
+            }
+        }
+        if (config.backends.empty()) {
+            config.backends = {"exact", "int8", "int8-rerank"};
+#ifdef ENABLE_FAISS
+            for (const char* type : {"flat", "ivf-flat", "ivf-pq", "hnsw"}) {
+                config.backends.push_back(type);
+            }
+#endif
+        }
+
+        std::cout << "[Bench] Generating " << config.jobs << " jobs x " << config.dimension << " dims, "
+                  << config.queries << " queries\n";
+        auto start = std::chrono::steady_clock::now();
+        Catalogue catalogue = generate_catalogue(config);
+        std::cout << "[Bench] Catalogue ready in " << static_cast<long long>(elapsed_ms(start)) << " ms\n";
+
+        // Exact search is the ground truth every backend's recall is measured against
+        std::vector<int64_t> truth(config.queries * config.k);
+        {
+            Backend exact;
+            if (!build_backend("exact", config, catalogue, "", exact)) {
+                return 1;
+            }
+            std::vector<float> scores(truth.size());
+            exact.search(catalogue.queries.data(), config.queries, config.k, truth.data(), scores.data());
+        }
+
+        std::string store_path = (std::filesystem::temp_directory_path() / "matcher_bench_store.bin").string();
+        json results = json::array();
+        for (const std::string& name : config.backends) {
+            Backend backend;
+            if (!build_backend(name, config, catalogue, store_path, backend)) {
+                std::cerr << "[Bench] Skipping " << name << "\n";
+                continue;
+            }
+            results.push_back(run_backend(backend, config, catalogue, truth));
+        }
+        std::error_code ignored;
+        std::filesystem::remove(store_path, ignored);
+
+        json report = {
+            {"config", {
+                {"jobs", config.jobs},
+                {"dimension", config.dimension},
+                {"clusters", config.clusters},
+                {"queries", config.queries},
+                {"k", config.k},
+                {"skills", config.skills},
+                {"skill_zipf", config.skill_zipf},
+                {"skills_per_job", config.skills_per_job},
+                {"rerank", config.rerank},
+                {"threads", config.threads},
+                {"nlist", config.faiss_options.nlist},
+                {"pq_m", config.faiss_options.pq_m},
+                {"hnsw_m", config.faiss_options.hnsw_m},
+                {"nprobe", config.faiss_options.nprobe},
+                {"ef_search", config.faiss_options.ef_search},
+                {"seed", config.seed}
+            }},
+            {"backends", results},
+            {"keywords", run_keyword_bench(config, catalogue, truth)}
+        };
+
+        std::ofstream file(config.output_path);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open " << config.output_path << " for writing\n";
+            return 1;
+        }
+        file << report.dump(2);
+        std::cout << "[Bench] Report written to " << config.output_path << "\n";
+        return 0;
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << std::endl;
+        return 1;
+    }
+}
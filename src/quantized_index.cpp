@@ -0,0 +1,145 @@
+#include "quantized_index.hpp"
+#include "distance_kernels.hpp"
+#include "top_k_heap.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <utility>
+
+const size_t SCAN_BLOCK_ROWS = 4096;  // Rows scored per query before moving on; int8 rows are a quarter the size
+
+Int8Index::Int8Index(int dimension)
+    : dimension_(dimension), code_stride_((static_cast<size_t>(dimension) + 63) / 64 * 64) {}
+
+Int8Index::Int8Index(std::shared_ptr<const MappedEmbeddingStore> store, bool keep_for_rerank)
+    : Int8Index(store->dimension()) {
+    count_ = store->size();
+    codes_.assign(count_ * code_stride_, 0);
+    scales_.resize(count_);
+    ids_.assign(store->ids(), store->ids() + count_);
+
+    // Store rows are already normalised
+    for (size_t i = 0; i < count_; i++) {
+        quantize_row(store->vectors() + i * store->stride(), i);
+    }
+    chunked_ = has_repeated_ids(ids_.data(), count_);
+    if (keep_for_rerank) {
+        store_ = std::move(store);
+    }
+}
+
+void Int8Index::quantize_row(const float* src, size_t row) {
+    float max_abs = 0.0f;
+    for (int d = 0; d < dimension_; d++) {
+        max_abs = std::max(max_abs, std::fabs(src[d]));
+    }
+
+    float scale = max_abs > 0.0f ? max_abs / 127.0f : 1.0f;
+    int8_t* codes = codes_.data() + row * code_stride_;
+    for (int d = 0; d < dimension_; d++) {
+        long code = std::lround(src[d] / scale);
+        codes[d] = static_cast<int8_t>(std::clamp(code, -127L, 127L));
+    }
+    scales_[row] = scale;
+}
+
+void Int8Index::add(const std::vector<int64_t>& ids, std::vector<float>& vectors) {
+    size_t count = ids.size();
+    size_t first = count_;
+    codes_.resize((first + count) * code_stride_, 0);
+    scales_.resize(first + count);
+
+    for (size_t i = 0; i < count; i++) {
+        float* src = vectors.data() + i * dimension_;
+        float norm = std::sqrt(dot_product(src, src, dimension_));
+        if (norm > 0.0f) {
+            for (int d = 0; d < dimension_; d++) {
+                src[d] /= norm;
+            }
+        }
+        quantize_row(src, first + i);
+    }
+
+    ids_.insert(ids_.end(), ids.begin(), ids.end());
+    count_ = ids_.size();
+    chunked_ = has_repeated_ids(ids_.data(), count_);
+    // The store no longer covers every row
+    store_.reset();
+}
+
+size_t Int8Index::memory_bytes() const {
+    return codes_.size() * sizeof(int8_t) + scales_.size() * sizeof(float) + ids_.size() * sizeof(int64_t);
+}
+
+void Int8Index::search(const float* queries, size_t nq, int k, int64_t* ids, float* scores,
+                       const IdFilter* filter) const {
+    size_t rows = count_;
+    size_t keep = std::min(static_cast<size_t>(k), rows);
+    const int64_t* chunk_ids = chunked_ ? ids_.data() : nullptr;
+
+    // Queries padded to the code stride so the kernel never needs a tail;
+    // like ExactIndex the buffers are per thread and reused between searches
+    static thread_local std::vector<float> padded;
+    padded.assign(nq * code_stride_, 0.0f);
+    for (size_t q = 0; q < nq; q++) {
+        std::memcpy(padded.data() + q * code_stride_, queries + q * dimension_, dimension_ * sizeof(float));
+    }
+
+    static thread_local std::vector<std::vector<ScoredRow>> heaps;
+    if (heaps.size() < nq) {
+        heaps.resize(nq);
+    }
+    for (size_t q = 0; q < nq; q++) {
+        heaps[q].clear();
+        heaps[q].reserve(keep + 1);
+    }
+
+    for (size_t block = 0; block < rows; block += SCAN_BLOCK_ROWS) {
+        size_t block_end = std::min(rows, block + SCAN_BLOCK_ROWS);
+        for (size_t q = 0; q < nq; q++) {
+            const float* query = padded.data() + q * code_stride_;
+            auto& heap = heaps[q];
+            for (size_t r = block; r < block_end; r++) {
+                if (filter && !filter->contains(ids_[r])) {
+                    continue;
+                }
+                float score = scales_[r] * dot_product_int8(query, codes_.data() + r * code_stride_, code_stride_);
+                offer_top_k(heap, keep, score, r, chunk_ids);
+            }
+        }
+    }
+
+    for (size_t q = 0; q < nq; q++) {
+        auto& heap = heaps[q];
+        std::sort_heap(heap.begin(), heap.end(), std::greater<ScoredRow>());
+
+        for (int i = 0; i < k; i++) {
+            size_t slot = q * k + i;
+            if (static_cast<size_t>(i) < heap.size()) {
+                ids[slot] = ids_[heap[i].second];
+                scores[slot] = heap[i].first;
+            } else {
+                ids[slot] = -1;
+                scores[slot] = -std::numeric_limits<float>::infinity();
+            }
+        }
+    }
+}
+
+void search_top_matches(const Int8Index* index, const std::vector<float>& query,
+                        int k, std::vector<int64_t>& ids, std::vector<float>& scores,
+                        const IdFilter* filter) {
+    ids.resize(k);
+    scores.resize(k);
+    index->search(query.data(), 1, k, ids.data(), scores.data(), filter);
+}
+
+void search_top_matches_batch(const Int8Index* index, const std::vector<float>& queries,
+                              size_t nq, int k, std::vector<int64_t>& ids,
+                              std::vector<float>& scores, const IdFilter* filter) {
+    ids.resize(nq * k);
+    scores.resize(nq * k);
+    index->search(queries.data(), nq, k, ids.data(), scores.data(), filter);
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "embedding_store.hpp"
+#include "id_filter.hpp"
+
+// Scalar-quantised cosine index: each L2-normalised row is stored as int8
+// codes plus one float scale (max |x| / 127), about a quarter of the fp32
+// footprint. Queries stay fp32 and are scored against the codes directly
+// (asymmetric distance), so only the job side loses precision.
+//
+// Scores stay approximate; the matcher's ExactRescorer stage rescores the
+// candidates against a mapped store's fp32 rows, reading only their pages,
+// so the full-precision vectors never need to be resident.
+class Int8Index {
+public:
+    explicit Int8Index(int dimension);
+
+    // Quantise every row of a mapped store. With keep_for_rerank the index
+    // holds on to the store so it stays mapped for an exact rescoring stage;
+    // otherwise it is released once quantised.
+    Int8Index(std::shared_ptr<const MappedEmbeddingStore> store, bool keep_for_rerank);
+
+    // Append count row-major vectors keyed by ids; vectors are normalised in place.
+    // Rows added this way have no fp32 copy in the store.
+    // Several rows may share an id (chunks of one long job description).
+    void add(const std::vector<int64_t>& ids, std::vector<float>& vectors);
+
+    // Top-k for nq row-major queries (assumed normalised), laid out like
+    // ExactIndex::search, with approximate scores. A filter restricts the scan to the ids it contains. As in ExactIndex,
+    // a job with several chunk rows appears once, scored by its best chunk.
+    void search(const float* queries, size_t nq, int k, int64_t* ids, float* scores,
+                const IdFilter* filter = nullptr) const;
+
+    int dimension() const { return dimension_; }
+    size_t size() const { return count_; }
+    // Whether some job has more than one row
+    bool chunked() const { return chunked_; }
+    // Bytes held for codes, scales and ids
+    size_t memory_bytes() const;
+
+private:
+    void quantize_row(const float* src, size_t row);
+
+    int dimension_;
+    size_t code_stride_;  // Codes per stored row (dimension rounded up to 64 bytes)
+    size_t count_ = 0;
+    bool chunked_ = false;
+    std::vector<int8_t> codes_;
+    std::vector<float> scales_;
+    std::vector<int64_t> ids_;
+    std::shared_ptr<const MappedEmbeddingStore> store_;
+};
+
+void search_top_matches(const Int8Index* index, const std::vector<float>& query,
+                        int k, std::vector<int64_t>& ids, std::vector<float>& scores,
+                        const IdFilter* filter = nullptr);
+
+void search_top_matches_batch(const Int8Index* index, const std::vector<float>& queries,
+                              size_t nq, int k, std::vector<int64_t>& ids,
+                              std::vector<float>& scores, const IdFilter* filter = nullptr);
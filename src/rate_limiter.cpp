@@ -0,0 +1,134 @@
+#include "rate_limiter.hpp"
+#include <algorithm>
+#include <iostream>
+
+// Slowest a site gets relative to its configured interval
+const double MAX_SLOWDOWN = 16.0;
+// Successes in backoff before the interval is halved again
+const int SUCCESSES_TO_RECOVER = 3;
+// Non-throttling failures in a row before the site is slowed down
+const int FAILURES_TO_SLOW = 3;
+
+void RateLimiter::set_limit(const std::string& site, const RateLimit& limit) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto inserted = buckets_.emplace(site, Bucket());
+    Bucket& bucket = inserted.first->second;
+    bucket.limit = limit;
+    bucket.limit.burst = std::max(limit.burst, 1.0);
+    if (inserted.second) {
+        // A new site may send its whole burst straight away
+        bucket.info.tokens = bucket.limit.burst;
+        bucket.info.refilled = Clock::now();
+    }
+    bucket.info.tokens = std::min(bucket.info.tokens, bucket.limit.burst);
+}
+
+RateLimiter::Clock::duration RateLimiter::effective_interval(const Bucket& bucket) {
+    return std::chrono::duration_cast<Clock::duration>(bucket.limit.interval * bucket.info.slowdown);
+}
+
+void RateLimiter::refill(Bucket& bucket, Clock::time_point now) {
+    RateLimitInfo& info = bucket.info;
+    if (now <= info.refilled) {
+        return;
+    }
+    Clock::duration interval = effective_interval(bucket);
+    if (interval.count() > 0) {
+        double earned = std::chrono::duration<double>(now - info.refilled) / interval;
+        info.tokens = std::min(bucket.limit.burst, info.tokens + earned);
+    }
+    info.refilled = now;
+}
+
+RateLimiter::Clock::time_point RateLimiter::try_acquire(const std::string& site, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = buckets_.find(site);
+    if (it == buckets_.end()) {
+        return now;
+    }
+    Bucket& bucket = it->second;
+    RateLimitInfo& info = bucket.info;
+    refill(bucket, now);
+    if (now < info.hold_until) {
+        return info.hold_until;
+    }
+    if (bucket.limit.interval.count() <= 0) {
+        return now;
+    }
+    if (info.tokens < 1.0) {
+        // Rounded up and never zero: returning now means a token was taken
+        auto missing = std::chrono::ceil<Clock::duration>(effective_interval(bucket) * (1.0 - info.tokens));
+        return now + std::max(missing, Clock::duration(1));
+    }
+
+    // Jitter goes on top of the time the next token is due, so sends end up
+    // interval plus a random part of jitter apart
+    info.tokens -= 1.0;
+    info.hold_until = now;
+    if (info.tokens < 1.0) {
+        info.hold_until += std::chrono::ceil<Clock::duration>(effective_interval(bucket) * (1.0 - info.tokens));
+    }
+    if (bucket.limit.jitter.count() > 0) {
+        info.hold_until += std::chrono::milliseconds(random_() % (bucket.limit.jitter.count() + 1));
+    }
+    return now;
+}
+
+void RateLimiter::pause(const std::string& site, Clock::duration cooldown, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RateLimitInfo& info = buckets_[site].info;
+    info.hold_until = std::max(info.hold_until, now + cooldown);
+}
+
+void RateLimiter::record(const std::string& site, bool ok, long http_code, Clock::time_point now) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = buckets_.find(site);
+    if (it == buckets_.end()) {
+        return;
+    }
+    Bucket& bucket = it->second;
+    RateLimitInfo& info = bucket.info;
+    // Tokens earned so far accrue at the rate that was in force
+    refill(bucket, now);
+
+    if (ok) {
+        info.consecutive_successes++;
+        info.consecutive_failures = 0;
+        if (info.backoff_mode && info.consecutive_successes > SUCCESSES_TO_RECOVER) {
+            info.consecutive_successes = 0;
+            info.slowdown /= 2.0;
+            if (info.slowdown <= 1.0) {
+                info.slowdown = 1.0;
+                info.backoff_mode = false;
+                std::cerr << "[RateLimiter] " << site << " left backoff\n";
+            }
+        }
+        return;
+    }
+
+    bool throttled = http_code == 429 || http_code == 403 || http_code == 999;
+    if (!throttled && http_code > 0 && http_code < 500) {
+        // A missing page says nothing about how loaded the site is
+        return;
+    }
+    info.consecutive_failures++;
+    info.consecutive_successes = 0;
+    if (throttled) {
+        // The site pushed back: slow down and spend no saved-up burst
+        info.slowdown = std::min(info.slowdown * 2.0, MAX_SLOWDOWN);
+        info.tokens = 0.0;
+    } else if (info.consecutive_failures >= FAILURES_TO_SLOW) {
+        info.slowdown = std::min(info.slowdown * 1.5, MAX_SLOWDOWN);
+    } else {
+        return;
+    }
+    info.backoff_mode = true;
+    std::cerr << "[RateLimiter] " << site << " in backoff, one request per "
+              << std::chrono::duration<double>(effective_interval(bucket)).count() << " s\n";
+}
+
+RateLimitInfo RateLimiter::info(const std::string& site) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = buckets_.find(site);
+    return it == buckets_.end() ? RateLimitInfo() : it->second.info;
+}
@@ -0,0 +1,66 @@
+#pragma once
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <random>
+#include <string>
+
+// Request budget of one site
+struct RateLimit {
+    std::chrono::milliseconds interval{0}; // One token per interval; zero leaves the site unlimited
+    std::chrono::milliseconds jitter{0};   // Random extra wait added to each gap, up to this much
+    double burst = 1.0;                    // Tokens the bucket holds, i.e. sends allowed back to back
+};
+
+// Adaptive state of a site's bucket
+struct RateLimitInfo {
+    double tokens = 0.0;
+    std::chrono::steady_clock::time_point refilled;   // When tokens was last brought up to date
+    std::chrono::steady_clock::time_point hold_until; // Next token's due time plus jitter, or a pause
+    double slowdown = 1.0;                            // Interval multiplier while backing off
+    int consecutive_successes = 0;
+    int consecutive_failures = 0;
+    bool backoff_mode = false;
+};
+
+// Per-site token buckets. Nothing here sleeps: try_acquire() either takes a
+// token or says when one will be available, so a fetch queue can hold the
+// request and serve other sites meanwhile. Responses fed to record() adapt
+// the rate: throttling answers (429, 403, 999) put the site in backoff and
+// double its interval, a run of other failures stretches it by half, and
+// each few successes in backoff halve it again. Safe to use from any thread.
+// Together with the fetch engine's queues this is the scraper's one
+// politeness scheduler: every wait for a site happens here.
+class RateLimiter {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void set_limit(const std::string& site, const RateLimit& limit);
+
+    // Take a token for site and return now, or return when the next token
+    // is due without taking one. Sites without a limit get now unless paused.
+    Clock::time_point try_acquire(const std::string& site, Clock::time_point now);
+
+    // Grant site nothing for cooldown from now (limited or not); other sites carry on
+    void pause(const std::string& site, Clock::duration cooldown, Clock::time_point now = Clock::now());
+
+    // Outcome of a request sent with a token; http_code is 0 for transport errors
+    void record(const std::string& site, bool ok, long http_code, Clock::time_point now = Clock::now());
+
+    RateLimitInfo info(const std::string& site) const;
+
+private:
+    struct Bucket {
+        RateLimit limit;
+        RateLimitInfo info;
+    };
+
+    // Interval between tokens under the current slowdown
+    static Clock::duration effective_interval(const Bucket& bucket);
+    // Bring tokens up to date with now
+    static void refill(Bucket& bucket, Clock::time_point now);
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Bucket> buckets_;
+    std::mt19937 random_{std::random_device{}()};
+};
@@ -0,0 +1,113 @@
+#include "reranker.hpp"
+#include "distance_kernels.hpp"
+#include "job_attributes.hpp"
+#include "match_engine.hpp"
+#include "skill_index.hpp"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <limits>
+#include <numeric>
+
+void CandidateList::clear() {
+    ids.clear();
+    similarity.clear();
+    keyword.clear();
+    score.clear();
+}
+
+void CandidateList::add(int64_t id, float embedding_similarity) {
+    ids.push_back(id);
+    similarity.push_back(embedding_similarity);
+    keyword.push_back(0.0f);
+    score.push_back(embedding_similarity);
+}
+
+void CandidateList::retain_similarity(float threshold) {
+    size_t kept = 0;
+    for (size_t i = 0; i < ids.size(); i++) {
+        if (similarity[i] < threshold) {
+            continue;
+        }
+        ids[kept] = ids[i];
+        similarity[kept] = similarity[i];
+        keyword[kept] = keyword[i];
+        score[kept] = score[i];
+        kept++;
+    }
+    ids.resize(kept);
+    similarity.resize(kept);
+    keyword.resize(kept);
+    score.resize(kept);
+}
+
+ExactRescorer::ExactRescorer(std::shared_ptr<const MappedEmbeddingStore> store) : store_(std::move(store)) {
+    const int64_t* ids = store_->ids();
+    std::vector<uint32_t> rows(store_->size());
+    std::iota(rows.begin(), rows.end(), 0);
+    std::sort(rows.begin(), rows.end(), [&](uint32_t a, uint32_t b) { return ids[a] < ids[b]; });
+    sorted_ids_.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); i++) {
+        sorted_ids_[i] = ids[rows[i]];
+    }
+    sorted_rows_.swap(rows);
+}
+
+void ExactRescorer::rerank(const RerankQuery& query, CandidateList& candidates) const {
+    const float* vectors = store_->vectors();
+    size_t stride = store_->stride();
+    for (size_t i = 0; i < candidates.size(); i++) {
+        auto range = std::equal_range(sorted_ids_.begin(), sorted_ids_.end(), candidates.ids[i]);
+        if (range.first == range.second) {
+            // Added after the store was written; keep the index's estimate
+            continue;
+        }
+        float best = -std::numeric_limits<float>::infinity();
+        for (auto it = range.first; it != range.second; ++it) {
+            const float* row = vectors + sorted_rows_[it - sorted_ids_.begin()] * stride;
+            for (size_t s = 0; s < query.sections; s++) {
+                best = std::max(best, dot_product(query.rows + s * query.dimension, row, query.dimension));
+            }
+        }
+        candidates.similarity[i] = best;
+        candidates.score[i] = best;
+    }
+}
+
+void KeywordFusion::rerank(const RerankQuery& query, CandidateList& candidates) const {
+    // BM25 over the candidates, scaled so the best keyword match scores 1
+    // like the capped keyword score of job_matcher.py
+    std::fill(candidates.keyword.begin(), candidates.keyword.end(), 0.0f);
+    if (index_ && query.terms) {
+        index_->score(*query.terms, candidates.ids.data(), candidates.size(), candidates.keyword.data());
+    }
+    float best_keyword = candidates.keyword.empty()
+                             ? 0.0f
+                             : *std::max_element(candidates.keyword.begin(), candidates.keyword.end());
+    if (best_keyword > 0.0f) {
+        for (float& score : candidates.keyword) {
+            score /= best_keyword;
+        }
+    }
+
+    const MatchOptions& options = *query.options;
+    for (size_t i = 0; i < candidates.size(); i++) {
+        candidates.score[i] = options.embedding_weight * candidates.similarity[i] +
+                              options.keyword_weight * candidates.keyword[i];
+    }
+}
+
+void RecencyBoost::rerank(const RerankQuery& query, CandidateList& candidates) const {
+    const MatchOptions& options = *query.options;
+    if (!attributes_ || options.recency_weight == 0.0f || options.recency_half_life_days <= 0.0f) {
+        return;
+    }
+    std::time_t now = std::time(nullptr);
+    for (size_t i = 0; i < candidates.size(); i++) {
+        double age = attributes_->age_days(candidates.ids[i], now);
+        if (age >= 0.0) {
+            candidates.score[i] += options.recency_weight *
+                                   static_cast<float>(std::exp2(-age / options.recency_half_life_days));
+        }
+    }
+}
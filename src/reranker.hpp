@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "embedding_store.hpp"
+
+struct MatchOptions;
+class SkillIndex;
+class JobAttributes;
+
+// Candidates of one CV in structure-of-arrays form, so every re-rank stage
+// walks contiguous buffers. Stages rewrite the score columns in place and
+// the engine ranks by score once the last one has run.
+struct CandidateList {
+    std::vector<int64_t> ids;
+    std::vector<float> similarity; // Embedding similarity; approximate until an exact stage rescores it
+    std::vector<float> keyword;    // Keyword relevance, the best candidate scaled to 1
+    std::vector<float> score;      // Combined ranking score
+
+    size_t size() const { return ids.size(); }
+    void clear();
+    void add(int64_t id, float embedding_similarity);
+    // Drop the candidates whose similarity is under threshold, keeping their order
+    void retain_similarity(float threshold);
+};
+
+// What a stage sees of the CV besides its candidates
+struct RerankQuery {
+    const float* rows = nullptr;                 // sections normalised query rows of dimension floats
+    size_t sections = 1;
+    int dimension = 0;
+    const std::vector<uint32_t>* terms = nullptr; // SkillIndex terms of the CV text; empty when unknown
+    const MatchOptions* options = nullptr;
+};
+
+// One stage of the precise second pass over the few hundred candidates the
+// index search returns. Stages are shared by every matching thread, so
+// rerank() must not mutate the stage itself.
+class Reranker {
+public:
+    virtual ~Reranker() = default;
+    virtual void rerank(const RerankQuery& query, CandidateList& candidates) const = 0;
+    // Short fixed name, hashed into result cache keys
+    virtual const char* name() const = 0;
+};
+
+// Replaces approximate similarities (int8 codes, IVF-PQ, HNSW) with the
+// full-precision cosine from the mapped store: the best pair of CV section
+// and job chunk, as the exact scan computes it.
+class ExactRescorer : public Reranker {
+public:
+    explicit ExactRescorer(std::shared_ptr<const MappedEmbeddingStore> store);
+    void rerank(const RerankQuery& query, CandidateList& candidates) const override;
+    const char* name() const override { return "exact"; }
+
+private:
+    std::shared_ptr<const MappedEmbeddingStore> store_;
+    // Store rows ordered by job id, so a job's chunks are one equal_range
+    std::vector<int64_t> sorted_ids_;
+    std::vector<uint32_t> sorted_rows_;
+};
+
+// BM25 skill and title overlap with the CV text, fused with the embedding
+// similarity using the option weights. Without an index (or CV text) the
+// keyword column stays zero.
+class KeywordFusion : public Reranker {
+public:
+    explicit KeywordFusion(const SkillIndex* index) : index_(index) {}
+    void rerank(const RerankQuery& query, CandidateList& candidates) const override;
+    const char* name() const override { return "keyword"; }
+
+private:
+    const SkillIndex* index_;
+};
+
+// Adds recency_weight to the score of a job scraped just now, halving every
+// recency_half_life_days. Jobs without a scrape date get no boost.
+class RecencyBoost : public Reranker {
+public:
+    explicit RecencyBoost(const JobAttributes* attributes) : attributes_(attributes) {}
+    void rerank(const RerankQuery& query, CandidateList& candidates) const override;
+    const char* name() const override { return "recency"; }
+
+private:
+    const JobAttributes* attributes_;
+};
@@ -0,0 +1,93 @@
+#include "result_cache.hpp"
+#include <algorithm>
+#include <cmath>
+
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    uint64_t hash = seed;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+uint64_t fingerprint_embedding(const std::vector<float>& embedding) {
+    float max_abs = 0.0f;
+    for (float x : embedding) {
+        max_abs = std::max(max_abs, std::fabs(x));
+    }
+
+    std::vector<int8_t> codes(embedding.size(), 0);
+    if (max_abs > 0.0f) {
+        float scale = 127.0f / max_abs;
+        for (size_t i = 0; i < embedding.size(); i++) {
+            codes[i] = static_cast<int8_t>(std::lround(embedding[i] * scale));
+        }
+    }
+    return hash_bytes(codes.data(), codes.size());
+}
+
+bool ResultCache::get(uint64_t key, std::vector<Job>& matches) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        misses_++;
+        return false;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    matches = it->second->second;
+    hits_++;
+    return true;
+}
+
+void ResultCache::put(uint64_t key, const std::vector<Job>& matches) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (capacity_ == 0) {
+        return;
+    }
+
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+        it->second->second = matches;
+        entries_.splice(entries_.begin(), entries_, it->second);
+        return;
+    }
+
+    entries_.emplace_front(key, matches);
+    index_[key] = entries_.begin();
+    while (entries_.size() > capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+}
+
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.clear();
+    index_.clear();
+}
+
+void ResultCache::set_capacity(size_t capacity) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    capacity_ = capacity;
+    while (entries_.size() > capacity_) {
+        index_.erase(entries_.back().first);
+        entries_.pop_back();
+    }
+}
+
+size_t ResultCache::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return entries_.size();
+}
+
+uint64_t ResultCache::hits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+uint64_t ResultCache::misses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "cv_job_matcher.hpp"
+
+// 64-bit FNV-1a, chainable through seed
+uint64_t hash_bytes(const void* data, size_t size, uint64_t seed = 14695981039346656037ULL);
+
+// Hash of the embedding quantised to int8 against its largest component.
+// Scaling does not change it, and float noise from re-embedding the same CV
+// lands on the same fingerprint.
+uint64_t fingerprint_embedding(const std::vector<float>& embedding);
+
+// Bounded LRU map from a request fingerprint to its match list. Safe to
+// share between threads.
+class ResultCache {
+public:
+    explicit ResultCache(size_t capacity = 0) : capacity_(capacity) {}
+
+    // Copy the cached matches for key into matches; false on a miss
+    bool get(uint64_t key, std::vector<Job>& matches);
+    // Insert or refresh key, evicting the least recently used entry when full
+    void put(uint64_t key, const std::vector<Job>& matches);
+    void clear();
+
+    // capacity 0 disables the cache
+    void set_capacity(size_t capacity);
+    size_t capacity() const { return capacity_; }
+    size_t size() const;
+    uint64_t hits() const;
+    uint64_t misses() const;
+
+private:
+    using Entry = std::pair<uint64_t, std::vector<Job>>;
+
+    mutable std::mutex mutex_;
+    size_t capacity_;
+    std::list<Entry> entries_; // Most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index_;
+    uint64_t hits_ = 0;
+    uint64_t misses_ = 0;
+};
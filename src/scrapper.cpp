@@ -10,13 +10,17 @@
 #include <fstream>
 #include <algorithm>
 #include <cstdlib>
+#include <cctype>
 #include <optional>
 #include <filesystem>
 #include <regex>
 #include <set>
+#include <future>
+#include <memory>
 #include <curl/curl.h>
 #include <gumbo.h>
 #include <nlohmann/json.hpp>
+#include "fetch_engine.hpp"
 
 using namespace std::literals;
 using json = nlohmann::json;
@@ -79,6 +83,10 @@ struct SearchConfig
 // Function declarations
 json fetch_dice_job_details(const std::string &job_url, const SiteConfig &site_config, const SearchConfig &search_cfg);
 json fetch_simplyhired_job_details(const std::string &job_url, const SiteConfig &site_config, const SearchConfig &search_cfg);
+json parse_simplyhired_job_details(const std::string &html);
+json parse_dice_job_details(const std::string &job_url, const FetchResult &result);
+FetchRequest dice_detail_request(const std::string &job_url);
+void reset_dice_session_if_failing();
 
 // Custom exception for error handling
 class ScraperException : public std::runtime_error
@@ -87,13 +95,6 @@ public:
     ScraperException(const std::string &msg) : std::runtime_error(msg) {}
 };
 
-// CURL callback function for retrieving web content
-static size_t WriteCallback(void *contents, size_t size, size_t nmemb, void *userp)
-{
-    ((std::string *)userp)->append((char *)contents, size * nmemb);
-    return size * nmemb;
-}
-
 // Function to fetch a web page with error handling and retry logic
 // Add this at the top of your file, near other globals
 const std::vector<std::string> USER_AGENTS = {
@@ -123,92 +124,55 @@ std::string generate_random_string(size_t length)
     return str;
 }
 
-// Rate limiting structure
-struct RateLimitInfo
-{
-    std::chrono::seconds delay{5}; // Initial delay
-    int consecutive_successes{0};
-    int consecutive_failures{0};
-    std::chrono::time_point<std::chrono::system_clock> last_request;
-    bool backoff_mode{false};
-};
-
-// Global map to store rate limit info for each site
-std::map<std::string, RateLimitInfo> rate_limits;
-
-// Function to enforce rate limits before making requests
-void enforce_rate_limits(const std::string &site_name)
+// Shared asynchronous fetcher; main creates it after curl_global_init
+std::unique_ptr<FetchEngine> fetch_engine;
+
+// The scraper's politeness schedule: how far apart the fetch engine starts
+// requests to each site, result pages and detail pages alike. These are the
+// delays the sequential scraper slept through; a site without a tuned entry
+// waits its SiteConfig delay plus up to as much again. Only the site itself
+// is held back, so the others keep fetching during its cooldown. Up to
+// max_streams requests per site may be outstanding, which over HTTP/2 is
+// one connection carrying that many streams. The engine's rate limiter
+// widens the spacing while a site answers 429 or 403 and narrows it again
+// as requests succeed.
+void configure_fetch_politeness(FetchEngine &engine, const std::vector<SiteConfig> &sites, size_t max_streams)
 {
-    auto now = std::chrono::system_clock::now();
-
-    if (rate_limits.find(site_name) == rate_limits.end())
+    for (const auto &site : sites)
     {
-        // Initialize with default values
-        rate_limits[site_name].delay = std::chrono::seconds(5);
-        rate_limits[site_name].last_request = now - std::chrono::hours(1);
-    }
-
-    auto &info = rate_limits[site_name];
-
-    // Calculate elapsed time since last request
-    auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - info.last_request);
-
-    // Determine appropriate delay based on site and current status
-    std::chrono::seconds required_delay(5); // Default
-
-    if (site_name == "LinkedIn")
-    {
-        required_delay = std::chrono::seconds(30);
-    }
-    else if (site_name == "Indeed")
-    {
-        required_delay = std::chrono::seconds(15);
-    }
-    else if (site_name == "Dice" || site_name == "SimplyHired")
-    {
-        required_delay = std::chrono::seconds(3);
-    }
-
-    // Apply backoff if needed
-    if (info.backoff_mode)
-    {
-        required_delay *= 1.2;
-        std::cout << "  Site " << site_name << " in backoff mode with " << required_delay.count() << "s delay" << std::endl;
-    }
-
-    // Add randomness
-    required_delay += std::chrono::seconds(std::rand() % 5);
-
-    // Wait if needed
-    if (elapsed < required_delay)
-    {
-        auto wait_time = required_delay - elapsed;
-        std::cout << "  Rate limiting: waiting " << wait_time.count() << " seconds for " << site_name << std::endl;
-        std::this_thread::sleep_for(wait_time);
+        SitePolicy policy;
+        policy.max_in_flight = max_streams;
+        if (site.name == "LinkedIn")
+        {
+            policy.min_interval = std::chrono::seconds(2);
+        }
+        else if (site.name == "SimplyHired")
+        {
+            policy.min_interval = std::chrono::seconds(3);
+            policy.jitter = std::chrono::seconds(4);
+        }
+        else if (site.name == "Dice")
+        {
+            policy.min_interval = std::chrono::seconds(4);
+            policy.jitter = std::chrono::seconds(4);
+        }
+        else
+        {
+            policy.min_interval = site.delay;
+            policy.jitter = site.delay;
+        }
+        engine.set_site_policy(site.name, policy);
     }
-
-    // Update last request time
-    info.last_request = std::chrono::system_clock::now();
 }
 
-// Updated fetch_page function
-std::string fetch_page(const std::string &url, int retries = 3, const std::string &site_name = "")
+// Browser-like request for url: rotating user agent, site referer and
+// cookies, and the headers a real navigation sends. ua_index receives the
+// position of the chosen agent in USER_AGENTS (or the LinkedIn list).
+FetchRequest browser_request(const std::string &url, const std::string &site_name, size_t &ua_index)
 {
-    // Apply rate limiting if site name is provided
-    if (!site_name.empty())
-    {
-        enforce_rate_limits(site_name);
-    }
-
-    CURL *curl = curl_easy_init();
-    if (!curl)
-        throw ScraperException("Failed to initialize CURL");
-
-    std::string buffer;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    FetchRequest request;
+    request.url = url;
+    request.site = site_name;
 
     // Enhanced browser impersonation with randomized details
     std::string browser_version = "120.0.0." + std::to_string(std::rand() % 100);
@@ -226,7 +190,7 @@ std::string fetch_page(const std::string &url, int retries = 3, const std::strin
                              " (KHTML, like Gecko) Chrome/" + browser_version + " Safari/" + webkit_version;
 
     // For tracking which user agent we're using
-    size_t ua_index = 0;
+    ua_index = 0;
 
     // Site-specific user agents for better success
     if (site_name == "LinkedIn")
@@ -248,7 +212,7 @@ std::string fetch_page(const std::string &url, int retries = 3, const std::strin
         }
     }
 
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, user_agent.c_str());
+    request.user_agent = user_agent;
 
     // Add proxy support
     bool use_proxy = false; // Set to true when you have actual proxies
@@ -265,24 +229,18 @@ std::string fetch_page(const std::string &url, int retries = 3, const std::strin
         if (!PROXIES.empty())
         {
             size_t proxy_index = std::rand() % PROXIES.size();
-            std::string proxy = PROXIES[proxy_index];
-            curl_easy_setopt(curl, CURLOPT_PROXY, proxy.c_str());
-            std::cout << "  Using proxy: " << proxy << std::endl;
+            request.proxy = PROXIES[proxy_index];
+            std::cout << "  Using proxy: " << request.proxy << std::endl;
         }
     }
 
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-
-    // Random 3-7 second delay
-    int delay_ms = 3000 + (std::rand() % 4000);
-    std::cout << "  Waiting for " << delay_ms / 1000.0 << " seconds before request..." << std::endl;
-    std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
+    request.timeout_seconds = 30;
+    request.connect_timeout_seconds = 10;
+    request.verify_peer = false;
 
     // FIX: Properly handle compressed content
-    // Some sites require this to be explicitly set to empty string rather than NULL
-    curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "");
+    // An empty encoding asks curl to accept every compression it supports
+    request.accept_encoding = "";
 
     // Set referer based on site
     std::string referer;
@@ -366,211 +324,153 @@ std::string fetch_page(const std::string &url, int retries = 3, const std::strin
     }
 
     // Enable cookies (simulates browser cookie handling)
-    static std::string cookie_file = "cookies.txt";
-    curl_easy_setopt(curl, CURLOPT_COOKIEFILE, cookie_file.c_str());
-    curl_easy_setopt(curl, CURLOPT_COOKIEJAR, cookie_file.c_str());
+    request.cookie_file = "cookies.txt";
 
     // Add request headers to look more like a browser
-    struct curl_slist *headers = NULL;
-    headers = curl_slist_append(headers, "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8");
-    headers = curl_slist_append(headers, "Accept-Language: en-US,en;q=0.5");
-    headers = curl_slist_append(headers, "Connection: keep-alive");
-    headers = curl_slist_append(headers, "Upgrade-Insecure-Requests: 1");
-    headers = curl_slist_append(headers, "Sec-Fetch-Dest: document");
-    headers = curl_slist_append(headers, "Sec-Fetch-Mode: navigate");
-    headers = curl_slist_append(headers, "Sec-Fetch-Site: none");
-    headers = curl_slist_append(headers, "Sec-Fetch-User: ?1");
-    headers = curl_slist_append(headers, "Cache-Control: max-age=0");
+    request.headers = {
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/avif,image/webp,*/*;q=0.8",
+        "Accept-Language: en-US,en;q=0.5",
+        "Connection: keep-alive",
+        "Upgrade-Insecure-Requests: 1",
+        "Sec-Fetch-Dest: document",
+        "Sec-Fetch-Mode: navigate",
+        "Sec-Fetch-Site: none",
+        "Sec-Fetch-User: ?1",
+        "Cache-Control: max-age=0"};
 
     // Browser fingerprint randomization
-    headers = curl_slist_append(headers, ("Viewport-Width: " + std::to_string(1200 + (std::rand() % 400))).c_str());
-    headers = curl_slist_append(headers, ("DPR: " + std::to_string(1 + (std::rand() % 2))).c_str());
-    headers = curl_slist_append(headers, "Sec-CH-UA: \"Chromium\";v=\"110\"");
-    headers = curl_slist_append(headers, "Sec-CH-UA-Mobile: ?0");
-    headers = curl_slist_append(headers, "Sec-CH-UA-Platform: \"Windows\"");
+    request.headers.push_back("Viewport-Width: " + std::to_string(1200 + (std::rand() % 400)));
+    request.headers.push_back("DPR: " + std::to_string(1 + (std::rand() % 2)));
+    request.headers.push_back("Sec-CH-UA: \"Chromium\";v=\"110\"");
+    request.headers.push_back("Sec-CH-UA-Mobile: ?0");
+    request.headers.push_back("Sec-CH-UA-Platform: \"Windows\"");
 
     // Add custom cookie header if we generated one
     if (!cookie_header.empty())
     {
-        headers = curl_slist_append(headers, ("Cookie: " + cookie_header).c_str());
+        request.headers.push_back("Cookie: " + cookie_header);
     }
 
     if (!referer.empty())
     {
-        std::string referer_header = "Referer: " + referer;
-        headers = curl_slist_append(headers, referer_header.c_str());
+        request.headers.push_back("Referer: " + referer);
     }
 
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
     // Verbose output for debugging
     if (site_name == "Indeed" || site_name == "ZipRecruiter" || site_name == "SimplyHired" || site_name == "Dice")
     {
-        curl_easy_setopt(curl, CURLOPT_VERBOSE, 1L);
+        request.verbose = true;
     }
 
-    CURLcode res = CURLE_OK;
+    return request;
+}
+
+// Fetch a page through the engine, which holds the request until the
+// site's rate limiter grants it and retries transient failures (curl
+// errors, 429, 5xx). Forbidden answers are retried here with another user
+// agent once the limiter, now backing off, lets the site go again.
+std::string fetch_page(const std::string &url, int retries = 3, const std::string &site_name = "")
+{
+    size_t ua_index = 0;
+    FetchRequest request = browser_request(url, site_name, ua_index);
+    request.attempts = retries;
+
+    FetchResult result;
     for (int i = 0; i < retries; i++)
     {
-        buffer.clear(); // Clear buffer for retry
-        res = curl_easy_perform(curl);
-
-        if (res == CURLE_OK)
+        result = fetch_engine->fetch(request).get();
+        if (result.curl_code != CURLE_OK || result.ok())
         {
-            long http_code = 0;
-            curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-
-            if (http_code >= 200 && http_code < 300)
-            {
-                // Update rate limit info on success
-                if (!site_name.empty())
-                {
-                    auto &info = rate_limits[site_name];
-                    info.consecutive_successes++;
-                    info.consecutive_failures = 0;
-
-                    // Exit backoff mode if we've had several successes
-                    if (info.backoff_mode && info.consecutive_successes > 3)
-                    {
-                        std::cout << "  Exiting backoff mode for " << site_name << std::endl;
-                        info.backoff_mode = false;
-                    }
-                }
-                break;
-            }
-            else
-            {
-                std::cerr << "HTTP error: " << http_code << " for URL: " << url << std::endl;
-
-                // Update rate limit info on failure
-                if (!site_name.empty())
-                {
-                    auto &info = rate_limits[site_name];
-                    info.consecutive_failures++;
-                    info.consecutive_successes = 0;
-
-                    // Enter backoff mode on certain errors
-                    if ((http_code == 429 || http_code == 403 || http_code == 999) && !info.backoff_mode)
-                    {
-                        std::cout << "  Entering backoff mode for " << site_name << std::endl;
-                        info.backoff_mode = true;
-                        info.delay *= 2;
-                    }
-                }
+            break;
+        }
 
-                // If it's a 429 (too many requests), wait longer
-                if (http_code == 429)
-                {
-                    std::cerr << "Rate limited (429). Waiting longer..." << std::endl;
-                    std::this_thread::sleep_for(std::chrono::seconds(60 * (i + 1)));
-                }
-                else if (http_code == 403 || http_code == 999)
-                {
-                    std::cerr << "Forbidden (" << http_code << "). Site might be blocking scraping: " << site_name << std::endl;
-                    // Save response for debugging
-                    std::string debug_path = "debug_" + std::to_string(http_code) + "_" + site_name + "_" +
-                                             std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + ".html";
-                    std::ofstream debug_file(debug_path);
-                    if (debug_file.is_open())
-                    {
-                        debug_file << buffer;
-                        debug_file.close();
-                        std::cerr << "Saved error response to: " << debug_path << std::endl;
-                    }
+        long http_code = result.http_code;
+        std::cerr << "HTTP error: " << http_code << " for URL: " << url << std::endl;
+        if (http_code != 403 && http_code != 999)
+        {
+            break;
+        }
 
-                    // Try a different user agent
-                    if (!USER_AGENTS.empty())
-                    {
-                        ua_index = (ua_index + 1) % USER_AGENTS.size();
-                        curl_easy_setopt(curl, CURLOPT_USERAGENT, USER_AGENTS[ua_index].c_str());
-                    }
-                    else
-                    {
-                        // Use backup agents if USER_AGENTS isn't available
-                        std::vector<std::string> backup_agents = {
-                            "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/91.0.4472.124 Safari/537.36 Edg/91.0.864.59",
-                            "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/605.1.15 (KHTML, like Gecko) Version/14.1.1 Safari/605.1.15",
-                            "Mozilla/5.0 (Windows NT 10.0; Win64; x64; rv:89.0) Gecko/20100101 Firefox/89.0"};
-                        std::string backup_agent = backup_agents[i % backup_agents.size()];
-                        curl_easy_setopt(curl, CURLOPT_USERAGENT, backup_agent.c_str());
-                    }
+        std::cerr << "Forbidden (" << http_code << "). Site might be blocking scraping: " << site_name << std::endl;
+        // Save response for debugging
+        std::string debug_path = "debug_" + std::to_string(http_code) + "_" + site_name + "_" +
+                                 std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + ".html";
+        std::ofstream debug_file(debug_path);
+        if (debug_file.is_open())
+        {
+            debug_file << result.body;
+            debug_file.close();
+            std::cerr << "Saved error response to: " << debug_path << std::endl;
+        }
 
-                    // Wait for a much longer time
-                    std::this_thread::sleep_for(std::chrono::seconds(120 + (60 * i)));
-                }
-            }
+        // Try a different user agent
+        if (!USER_AGENTS.empty())
+        {
+            ua_index = (ua_index + 1) % USER_AGENTS.size();
+            request.user_agent = USER_AGENTS[ua_index];
         }
         else
         {
-            std::cerr << "CURL attempt " << (i + 1) << " failed: " << curl_easy_strerror(res) << std::endl;
-
-            // For compression issues, try with different encoding settings
-            if (res == CURLE_BAD_CONTENT_ENCODING)
-            {
-                std::cerr << "Compression issue detected, trying different encoding settings..." << std::endl;
-                curl_easy_setopt(curl, CURLOPT_ACCEPT_ENCODING, "identity");
-            }
+            // Use backup agents if USER_AGENTS isn't available
+            std::vector<std::string> backup_agents = {
+                "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/91.0.4472.124 Safari/537.36 Edg/91.0.864.59",
+                "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/605.1.15 (KHTML, like Gecko) Version/14.1.1 Safari/605.1.15",
+                "Mozilla/5.0 (Windows NT 10.0; Win64; x64; rv:89.0) Gecko/20100101 Firefox/89.0"};
+            request.user_agent = backup_agents[i % backup_agents.size()];
         }
-
-        // Exponential backoff with randomization
-        int backoff_seconds = 3 * (i + 1) + (std::rand() % 5);
-        std::this_thread::sleep_for(std::chrono::seconds(backoff_seconds));
     }
 
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+    if (result.curl_code != CURLE_OK)
+        throw ScraperException(std::string("CURL error after retries: ") + curl_easy_strerror(result.curl_code));
 
-    if (res != CURLE_OK)
-        throw ScraperException(std::string("CURL error after retries: ") + curl_easy_strerror(res));
+    return result.body;
+}
+
+// Non-blocking fetch_page for detail pages: the fetch engine spaces the
+// requests by the site's politeness policy and retries transient failures,
+// so a whole result page of details can be requested at once
+std::future<FetchResult> fetch_page_async(const std::string &url, const std::string &site_name)
+{
+    size_t ua_index = 0;
+    FetchRequest request = browser_request(url, site_name, ua_index);
+    request.attempts = 3;
+    return fetch_engine->fetch(std::move(request));
+}
 
-    return buffer;
+// Minimal request LinkedIn answers without a login wall
+FetchRequest linkedin_request(const std::string &url)
+{
+    FetchRequest request;
+    request.url = url;
+    request.site = "LinkedIn";
+    request.user_agent = "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36";
+    request.timeout_seconds = 30;
+    request.connect_timeout_seconds = 10;
+    request.verify_peer = false;
+
+    // Add only essential headers; cookies stay in memory
+    request.headers = {
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/webp,*/*;q=0.8",
+        "Accept-Language: en-US,en;q=0.5"};
+    return request;
 }
 
 // Special fetch_page function for LinkedIn
 // Replace the current fetch_linkedin_page function with this simplified version
 std::string fetch_linkedin_page(const std::string &url)
 {
-    CURL *curl = curl_easy_init();
-    if (!curl)
-        throw ScraperException("Failed to initialize CURL");
-
-    std::string buffer;
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
-    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-    curl_easy_setopt(curl, CURLOPT_USERAGENT, "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/120.0.0.0 Safari/537.36");
-    curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-    curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
-    curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0L);
-
-    // Add cookie support (minimal)
-    curl_easy_setopt(curl, CURLOPT_COOKIEFILE, ""); // Enable cookies
+    FetchRequest request = linkedin_request(url);
+    FetchResult result = fetch_engine->fetch(std::move(request)).get();
 
-    // Add only essential headers
-    struct curl_slist *headers = NULL;
-    headers = curl_slist_append(headers, "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/webp,*/*;q=0.8");
-    headers = curl_slist_append(headers, "Accept-Language: en-US,en;q=0.5");
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-    // Add a simple delay
-    std::this_thread::sleep_for(std::chrono::seconds(2));
-
-    CURLcode res = curl_easy_perform(curl);
-
-    if (res != CURLE_OK)
+    if (result.curl_code != CURLE_OK)
     {
-        std::cerr << "LinkedIn CURL error: " << curl_easy_strerror(res) << std::endl;
+        std::cerr << "LinkedIn CURL error: " << curl_easy_strerror(result.curl_code) << std::endl;
+        throw ScraperException(std::string("LinkedIn CURL error: ") + curl_easy_strerror(result.curl_code));
     }
 
-    curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
-
-    if (res != CURLE_OK)
-        throw ScraperException(std::string("LinkedIn CURL error: ") + curl_easy_strerror(res));
-
-    return buffer;
+    return result.body;
 }
+
 // Function that was forward-declared earlier but needed implementation
 std::string normalize_url(const std::string &url, const std::string &base_url)
 {
@@ -786,23 +686,28 @@ std::string clean_text(const std::string &text)
 }
 
 // URL encode function for creating search URLs
+// Percent-encodes everything except RFC 3986 unreserved characters, exactly
+// like curl_easy_escape, without creating a curl handle for every call
 std::string url_encode(const std::string &value)
 {
-    CURL *curl = curl_easy_init();
-    if (!curl)
-        throw ScraperException("Failed to initialize CURL for URL encoding");
+    static const char hex[] = "0123456789ABCDEF";
 
-    char *output = curl_easy_escape(curl, value.c_str(), static_cast<int>(value.length()));
-    if (!output)
+    std::string result;
+    result.reserve(value.size() * 3);
+    for (unsigned char c : value)
     {
-        curl_easy_cleanup(curl);
-        throw ScraperException("Failed to URL encode string: " + value);
+        if (std::isalnum(c) || c == '-' || c == '.' || c == '_' || c == '~')
+        {
+            result += static_cast<char>(c);
+        }
+        else
+        {
+            result += '%';
+            result += hex[c >> 4];
+            result += hex[c & 0x0F];
+        }
     }
 
-    std::string result(output);
-    curl_free(output);
-    curl_easy_cleanup(curl);
-
     return result;
 }
 
@@ -999,6 +904,15 @@ json scrape_details(GumboNode *n, const SiteConfig &cfg, const SearchConfig &sea
     return j;
 }
 
+// Copy the fields of a detail page over the listing fields of job
+void merge_job_details(json &job, const json &details)
+{
+    for (auto it = details.begin(); it != details.end(); ++it)
+    {
+        job[it.key()] = it.value();
+    }
+}
+
 // Dice job processor function
 void process_dice_jobs(const SiteConfig &site, const SearchConfig &search_cfg,
                        std::vector<json> &all_jobs, int max_jobs)
@@ -1025,9 +939,6 @@ void process_dice_jobs(const SiteConfig &site, const SearchConfig &search_cfg,
 
             std::cout << "  Fetching Dice page " << page << ": " << page_url << std::endl;
 
-            // Fetch page HTML content with a longer delay
-            std::this_thread::sleep_for(std::chrono::seconds(5 + (std::rand() % 5)));
-
             std::string html;
             try
             {
@@ -1127,15 +1038,21 @@ void process_dice_jobs(const SiteConfig &site, const SearchConfig &search_cfg,
                 }
             }
 
-            // Process job containers
+            // Collect the valid jobs of this page, up to the job limit
+            std::vector<json> page_jobs;
+            std::vector<std::string> job_urls;
             for (auto *container : containers)
             {
+                if (all_jobs.size() + page_jobs.size() >= static_cast<size_t>(max_jobs))
+                {
+                    break;
+                }
+
                 json job = scrape_details(container, site, search_cfg);
 
                 // Only process valid jobs
                 if (!job.empty())
                 {
-                    // Get the job URL for fetching detailed information
                     // Get the job URL for fetching detailed information
                     std::string job_url = job["source"];
 
@@ -1145,35 +1062,44 @@ void process_dice_jobs(const SiteConfig &site, const SearchConfig &search_cfg,
                         job_url = normalize_url(job_url, site.base_url);
                     }
 
-                    if (!job_url.empty())
-                    {
-                        // Fetch detailed job information
-                        json detailed_info = fetch_dice_job_details(job_url, site, search_cfg);
-
-                        // Merge detailed info with basic job info
-                        for (auto it = detailed_info.begin(); it != detailed_info.end(); ++it)
-                        {
-                            job[it.key()] = it.value();
-                        }
-                    }
-                    all_jobs.push_back(job);
+                    page_jobs.push_back(job);
+                    job_urls.push_back(job_url);
+                }
+            }
 
-                    // Print basic info about the job
-                    std::cout << "  Scraped: "
-                              << job.value("title", "Unknown Title") << " at "
-                              << job.value("company", "Unknown Company") << " in "
-                              << job.value("location", "Unknown Location") << std::endl;
+            // Request every detail page at once; the fetch engine spaces them
+            // by Dice's politeness policy while earlier ones download
+            reset_dice_session_if_failing();
+            std::vector<std::future<FetchResult>> details(page_jobs.size());
+            for (size_t i = 0; i < page_jobs.size(); ++i)
+            {
+                if (!job_urls[i].empty())
+                {
+                    std::cout << "  Fetching Dice job details from: " << job_urls[i] << std::endl;
+                    details[i] = fetch_engine->fetch(dice_detail_request(job_urls[i]));
+                }
+            }
 
-                    // Break if we've reached the maximum number of jobs
-                    if (all_jobs.size() >= static_cast<size_t>(max_jobs))
-                    {
-                        std::cout << "  Reached maximum job limit (" << max_jobs << ")" << std::endl;
-                        break;
-                    }
+            for (size_t i = 0; i < page_jobs.size(); ++i)
+            {
+                json &job = page_jobs[i];
+                if (details[i].valid())
+                {
+                    // Merge detailed info with basic job info
+                    merge_job_details(job, parse_dice_job_details(job_urls[i], details[i].get()));
                 }
+                all_jobs.push_back(job);
+
+                // Print basic info about the job
+                std::cout << "  Scraped: "
+                          << job.value("title", "Unknown Title") << " at "
+                          << job.value("company", "Unknown Company") << " in "
+                          << job.value("location", "Unknown Location") << std::endl;
+            }
 
-                // Add a short delay between processing jobs
-                std::this_thread::sleep_for(std::chrono::milliseconds(500 + (std::rand() % 1000)));
+            if (all_jobs.size() >= static_cast<size_t>(max_jobs))
+            {
+                std::cout << "  Reached maximum job limit (" << max_jobs << ")" << std::endl;
             }
 
             // Clean up Gumbo parser
@@ -1184,9 +1110,6 @@ void process_dice_jobs(const SiteConfig &site, const SearchConfig &search_cfg,
             {
                 break;
             }
-
-            // Add a longer delay between pages
-            std::this_thread::sleep_for(std::chrono::seconds(2 + (std::rand() % 2)));
         }
     }
     catch (const std::exception &e)
@@ -1221,11 +1144,6 @@ void process_simplyhired_jobs(const SiteConfig &site, const SearchConfig &search
 
             std::cout << "  Fetching page " << page << ": " << page_url << std::endl;
 
-            // Add random delay before request
-            int delay_ms = 1000 + (std::rand() % 2000);
-            std::cout << "  Waiting for " << delay_ms / 1000.0 << " seconds before request..." << std::endl;
-            std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
-
             // Fetch page HTML content
             std::string html;
             try
@@ -1295,90 +1213,123 @@ void process_simplyhired_jobs(const SiteConfig &site, const SearchConfig &search
                 {
                     std::cout << "  Found " << job_links.size() << " job links directly" << std::endl;
 
-                    // Process each job link
+                    // Create a basic job entry for each link, up to the job limit
+                    std::vector<json> page_jobs;
                     for (auto *link : job_links)
                     {
+                        if (all_jobs.size() + page_jobs.size() >= static_cast<size_t>(max_jobs))
+                        {
+                            break;
+                        }
+
                         std::string job_url = extract_url(link, site.base_url);
                         std::string title = clean_text(extract_text(link));
 
                         if (!job_url.empty() && !title.empty())
                         {
-                            // Create a basic job entry
                             json job;
                             job["title"] = title;
                             job["source"] = job_url;
                             job["scraped_at"] = now_iso();
+                            page_jobs.push_back(job);
+                        }
+                    }
 
-                            // Fetch detailed job information
-                            json detailed_info = fetch_simplyhired_job_details(job_url, site, search_cfg);
+                    // Fetch every detail page concurrently, paced by the fetch engine
+                    std::vector<std::future<FetchResult>> details;
+                    for (const json &job : page_jobs)
+                    {
+                        std::cout << "  Fetching SimplyHired job details from: " << job["source"].get<std::string>() << std::endl;
+                        details.push_back(fetch_page_async(job["source"], site.name));
+                    }
 
+                    for (size_t i = 0; i < page_jobs.size(); ++i)
+                    {
+                        json &job = page_jobs[i];
+                        FetchResult result = details[i].get();
+                        if (result.ok())
+                        {
                             // Merge detailed info with basic job info
-                            for (auto it = detailed_info.begin(); it != detailed_info.end(); ++it)
-                            {
-                                job[it.key()] = it.value();
-                            }
-
-                            all_jobs.push_back(job);
+                            merge_job_details(job, parse_simplyhired_job_details(result.body));
+                        }
+                        else
+                        {
+                            std::cerr << "Error fetching SimplyHired job details: " << result.error() << std::endl;
+                        }
 
-                            std::cout << "  Scraped: " << title << std::endl;
+                        all_jobs.push_back(job);
 
-                            // Break if we've reached the maximum number of jobs
-                            if (all_jobs.size() >= static_cast<size_t>(max_jobs))
-                            {
-                                std::cout << "  Reached maximum job limit (" << max_jobs << ")" << std::endl;
-                                break;
-                            }
+                        std::cout << "  Scraped: " << job.value("title", "Unknown Title") << std::endl;
+                    }
 
-                            // Add delay between job processing
-                            std::this_thread::sleep_for(std::chrono::milliseconds(1000 + (std::rand() % 2000)));
-                        }
+                    if (all_jobs.size() >= static_cast<size_t>(max_jobs))
+                    {
+                        std::cout << "  Reached maximum job limit (" << max_jobs << ")" << std::endl;
                     }
                 }
             }
             else
             {
-                // Process containers normally
+                // Process containers normally, up to the job limit
+                std::vector<json> page_jobs;
                 for (auto *container : containers)
                 {
+                    if (all_jobs.size() + page_jobs.size() >= static_cast<size_t>(max_jobs))
+                    {
+                        break;
+                    }
+
                     // Get job information
                     json job = scrape_details(container, site, search_cfg);
 
                     // Only process valid jobs
                     if (!job.empty())
                     {
-                        // Get the job URL for fetching detailed information
-                        std::string job_url = job["source"];
+                        page_jobs.push_back(job);
+                    }
+                }
 
-                        if (!job_url.empty())
-                        {
-                            // Fetch detailed job information
-                            json detailed_info = fetch_simplyhired_job_details(job_url, site, search_cfg);
+                // Fetch every detail page concurrently, paced by the fetch engine
+                std::vector<std::future<FetchResult>> details(page_jobs.size());
+                for (size_t i = 0; i < page_jobs.size(); ++i)
+                {
+                    std::string job_url = page_jobs[i]["source"];
+                    if (!job_url.empty())
+                    {
+                        std::cout << "  Fetching SimplyHired job details from: " << job_url << std::endl;
+                        details[i] = fetch_page_async(job_url, site.name);
+                    }
+                }
 
+                for (size_t i = 0; i < page_jobs.size(); ++i)
+                {
+                    json &job = page_jobs[i];
+                    if (details[i].valid())
+                    {
+                        FetchResult result = details[i].get();
+                        if (result.ok())
+                        {
                             // Merge detailed info with basic job info
-                            for (auto it = detailed_info.begin(); it != detailed_info.end(); ++it)
-                            {
-                                job[it.key()] = it.value();
-                            }
+                            merge_job_details(job, parse_simplyhired_job_details(result.body));
                         }
-
-                        all_jobs.push_back(job);
-
-                        // Print basic info about the job
-                        std::cout << "  Scraped: "
-                                  << job.value("title", "Unknown Title") << " at "
-                                  << job.value("company", "Unknown Company") << " in "
-                                  << job.value("location", "Unknown Location") << std::endl;
-
-                        // Break if we've reached the maximum number of jobs
-                        if (all_jobs.size() >= static_cast<size_t>(max_jobs))
+                        else
                         {
-                            std::cout << "  Reached maximum job limit (" << max_jobs << ")" << std::endl;
-                            break;
+                            std::cerr << "Error fetching SimplyHired job details: " << result.error() << std::endl;
                         }
                     }
 
-                    // Add a small delay between processing jobs
-                    std::this_thread::sleep_for(std::chrono::milliseconds(1000 + (std::rand() % 2000)));
+                    all_jobs.push_back(job);
+
+                    // Print basic info about the job
+                    std::cout << "  Scraped: "
+                              << job.value("title", "Unknown Title") << " at "
+                              << job.value("company", "Unknown Company") << " in "
+                              << job.value("location", "Unknown Location") << std::endl;
+                }
+
+                if (all_jobs.size() >= static_cast<size_t>(max_jobs))
+                {
+                    std::cout << "  Reached maximum job limit (" << max_jobs << ")" << std::endl;
                 }
             }
 
@@ -1390,9 +1341,6 @@ void process_simplyhired_jobs(const SiteConfig &site, const SearchConfig &search
             {
                 break;
             }
-
-            // Respect the site's delay between requests to avoid being blocked
-            std::this_thread::sleep_for(site.delay + std::chrono::milliseconds(std::rand() % 5000));
         }
     }
     catch (const std::exception &e)
@@ -1472,9 +1420,6 @@ json fetch_linkedin_job_details(const std::string &job_url, const SiteConfig &si
     {
         std::cout << "  Fetching detailed job information from: " << job_url << std::endl;
 
-        // Add delay before fetching to avoid rate limiting
-        std::this_thread::sleep_for(std::chrono::seconds(2));
-
         // Fetch the job detail page - USING THE SPECIALIZED LINKEDIN FUNCTION
         std::string html = fetch_linkedin_page(job_url);
 
@@ -1631,95 +1576,106 @@ void process_linkedin_jobs(const SiteConfig &site, const SearchConfig &search_cf
 
             std::cout << "  Found " << containers.size() << " LinkedIn job listings" << std::endl;
 
-            // Extract job details from each container
+            // Extract the basic job information of each listing, up to the job limit
+            std::vector<json> page_jobs;
             for (auto *container : containers)
             {
-                // Get basic job information
+                if (all_jobs.size() + page_jobs.size() >= static_cast<size_t>(max_jobs))
+                {
+                    break;
+                }
+
                 json job = scrape_details(container, site, search_cfg);
 
                 // Only process valid jobs
                 if (!job.empty())
                 {
-                    // Get the job URL for fetching detailed information
-                    std::string job_url = job["source"];
+                    page_jobs.push_back(job);
+                }
+            }
 
-                    if (!job_url.empty())
+            // Request the detail pages together; the fetch engine spaces them
+            // by LinkedIn's politeness policy
+            std::vector<std::future<FetchResult>> details(page_jobs.size());
+            for (size_t i = 0; i < page_jobs.size(); ++i)
+            {
+                std::string job_url = page_jobs[i]["source"];
+                if (!job_url.empty())
+                {
+                    std::cout << "  Fetching LinkedIn job details from: " << job_url << std::endl;
+                    details[i] = fetch_engine->fetch(linkedin_request(job_url));
+                }
+            }
+
+            for (size_t i = 0; i < page_jobs.size(); ++i)
+            {
+                json &job = page_jobs[i];
+                if (details[i].valid())
+                {
+                    json detailed_info;
+                    try
                     {
-                        // Also update this to use fetch_linkedin_page:
-                        json detailed_info;
-                        try
+                        FetchResult result = details[i].get();
+                        if (result.curl_code != CURLE_OK)
                         {
-                            std::cout << "  Fetching LinkedIn job details from: " << job_url << std::endl;
-                            // Add delay before fetching to avoid rate limiting
-                            std::this_thread::sleep_for(std::chrono::seconds(2));
-
-                            // Fetch detailed job information using the specialized function
-                            std::string detail_html = fetch_linkedin_page(job_url);
+                            throw ScraperException(std::string("LinkedIn CURL error: ") + curl_easy_strerror(result.curl_code));
+                        }
 
-                            // Parse the details (you can keep using your existing detailed parsing logic)
-                            GumboOutput *detail_output = gumbo_parse(detail_html.c_str());
-                            if (detail_output)
+                        // Parse the details (you can keep using your existing detailed parsing logic)
+                        GumboOutput *detail_output = gumbo_parse(result.body.c_str());
+                        if (detail_output)
+                        {
+                            // Look for the job description container
+                            std::vector<GumboNode *> description_containers;
+
+                            // Try these selectors one by one
+                            const std::vector<std::pair<std::string, std::string>> selectors = {
+                                {"div", "jobs-description-content"},
+                                {"div", "jobs-box__html-content"},
+                                {"div", "description__text"},
+                                {"div", "show-more-less-html__markup"},
+                                {"div", "jobs-description__content"},
+                                {"section", "description"},
+                                {"div", "job-detail-body"},
+                                {"div", "job-description"}};
+
+                            for (const auto &selector : selectors)
                             {
-                                // Look for the job description container
-                                std::vector<GumboNode *> description_containers;
-
-                                // Try these selectors one by one
-                                const std::vector<std::pair<std::string, std::string>> selectors = {
-                                    {"div", "jobs-description-content"},
-                                    {"div", "jobs-box__html-content"},
-                                    {"div", "description__text"},
-                                    {"div", "show-more-less-html__markup"},
-                                    {"div", "jobs-description__content"},
-                                    {"section", "description"},
-                                    {"div", "job-detail-body"},
-                                    {"div", "job-description"}};
-
-                                for (const auto &selector : selectors)
-                                {
-                                    find_nodes(detail_output->root, selector.first, selector.second, description_containers);
-                                    if (!description_containers.empty())
-                                        break;
-                                }
-
+                                find_nodes(detail_output->root, selector.first, selector.second, description_containers);
                                 if (!description_containers.empty())
-                                {
-                                    std::string description = clean_text(extract_text(description_containers[0]));
-                                    detailed_info["description"] = description;
-                                }
+                                    break;
+                            }
 
-                                gumbo_destroy_output(&kGumboDefaultOptions, detail_output);
+                            if (!description_containers.empty())
+                            {
+                                std::string description = clean_text(extract_text(description_containers[0]));
+                                detailed_info["description"] = description;
                             }
-                        }
-                        catch (const std::exception &e)
-                        {
-                            std::cerr << "  Error fetching LinkedIn job details: " << e.what() << std::endl;
-                        }
 
-                        // Merge detailed info with basic job info
-                        for (auto it = detailed_info.begin(); it != detailed_info.end(); ++it)
-                        {
-                            job[it.key()] = it.value();
+                            gumbo_destroy_output(&kGumboDefaultOptions, detail_output);
                         }
                     }
-
-                    all_jobs.push_back(job);
-
-                    // Print basic info about the job
-                    std::cout << "  Scraped LinkedIn job: "
-                              << job.value("title", "Unknown Title") << " at "
-                              << job.value("company", "Unknown Company") << " in "
-                              << job.value("location", "Unknown Location") << std::endl;
-
-                    // Break if we've reached the maximum number of jobs
-                    if (all_jobs.size() >= static_cast<size_t>(max_jobs))
+                    catch (const std::exception &e)
                     {
-                        std::cout << "  Reached maximum job limit (" << max_jobs << ")" << std::endl;
-                        break;
+                        std::cerr << "  Error fetching LinkedIn job details: " << e.what() << std::endl;
                     }
+
+                    // Merge detailed info with basic job info
+                    merge_job_details(job, detailed_info);
                 }
 
-                // Add a small delay between processing jobs
-                std::this_thread::sleep_for(std::chrono::milliseconds(500));
+                all_jobs.push_back(job);
+
+                // Print basic info about the job
+                std::cout << "  Scraped LinkedIn job: "
+                          << job.value("title", "Unknown Title") << " at "
+                          << job.value("company", "Unknown Company") << " in "
+                          << job.value("location", "Unknown Location") << std::endl;
+            }
+
+            if (all_jobs.size() >= static_cast<size_t>(max_jobs))
+            {
+                std::cout << "  Reached maximum job limit (" << max_jobs << ")" << std::endl;
             }
 
             // Clean up Gumbo parser
@@ -1730,9 +1686,6 @@ void process_linkedin_jobs(const SiteConfig &site, const SearchConfig &search_cf
             {
                 break;
             }
-
-            // Respect the site's delay between requests
-            std::this_thread::sleep_for(site.delay);
         }
     }
     catch (const std::exception &e)
@@ -1743,20 +1696,28 @@ void process_linkedin_jobs(const SiteConfig &site, const SearchConfig &search_cf
 // Updated function for fetch_simplyhired_job_details
 json fetch_simplyhired_job_details(const std::string &job_url, const SiteConfig &site_config, const SearchConfig &search_cfg)
 {
-    json job_details;
-
     try
     {
         std::cout << "  Fetching SimplyHired job details from: " << job_url << std::endl;
 
-        // Add delay before request
-        int delay_ms = 2000 + (std::rand() % 4000);
-        std::cout << "  Waiting for " << delay_ms / 1000.0 << " seconds before request..." << std::endl;
-        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
-
         // Fetch the job detail page
-        std::string html = fetch_page(job_url, 3, "SimplyHired");
+        return parse_simplyhired_job_details(fetch_page(job_url, 3, "SimplyHired"));
+    }
+    catch (const std::exception &e)
+    {
+        std::cerr << "Error fetching SimplyHired job details: " << e.what() << std::endl;
+    }
+
+    return json();
+}
 
+// Extract company, location and description from a SimplyHired job page
+json parse_simplyhired_job_details(const std::string &html)
+{
+    json job_details;
+
+    try
+    {
         // Save the full HTML for debugging
         std::string debug_path = "debug_simplyhired_" +
                                  std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + ".html";
@@ -1861,146 +1822,144 @@ json fetch_simplyhired_job_details(const std::string &job_url, const SiteConfig
     }
     catch (const std::exception &e)
     {
-        std::cerr << "Error fetching SimplyHired job details: " << e.what() << std::endl;
+        std::cerr << "Error parsing SimplyHired job details: " << e.what() << std::endl;
     }
 
     return job_details;
 }
 
+// Dice session health, shared by every Dice detail fetch
+static int dice_failure_count = 0;
+static int dice_success_count = 0;
+
+// Back off for a while when Dice has refused every recent detail request
+void reset_dice_session_if_failing()
+{
+    // Check if we need to reset the session due to too many failures
+    if (dice_failure_count > 3 && dice_success_count < 1)
+    {
+        std::cout << "  Too many consecutive Dice failures. Resetting session..." << std::endl;
+        dice_failure_count = 0;
+
+        // Hold Dice requests for a longer period to reset the session;
+        // the other sites keep going meanwhile
+        fetch_engine->pause_site("Dice", std::chrono::minutes(2));
+    }
+}
+
+// Browser-like request for a Dice job detail page
+FetchRequest dice_detail_request(const std::string &job_url)
+{
+    // Special headers for Dice
+    std::vector<std::string> dice_user_agents = {
+        "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/123.0.0.0 Safari/537.36",
+        "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/605.1.15 (KHTML, like Gecko) Version/17.4 Safari/605.1.15",
+        "Mozilla/5.0 (Windows NT 10.0; Win64; x64; rv:124.0) Gecko/20100101 Firefox/124.0"};
+
+    FetchRequest request;
+    request.url = job_url;
+    request.site = "Dice";
+
+    // Set a very browser-like user agent for Dice
+    request.user_agent = dice_user_agents[std::rand() % dice_user_agents.size()];
+
+    // Create cookies that look more like a real browser session
+    std::string session_id = generate_random_string(32);
+    std::string visitor_id = generate_random_string(16);
+    std::string dice_cookie = "dice.search-id=" + session_id +
+                              "; dice.visitor-id=" + visitor_id +
+                              "; dice.session-started=true";
+
+    // Set up headers for Dice
+    request.headers = {
+        "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/webp,*/*;q=0.8",
+        "Accept-Language: en-US,en;q=0.5",
+        "Connection: keep-alive",
+        "Upgrade-Insecure-Requests: 1",
+        "Cache-Control: max-age=0",
+        "Sec-Fetch-Dest: document",
+        "Sec-Fetch-Mode: navigate",
+        "Sec-Fetch-Site: same-origin",
+        "Sec-Fetch-User: ?1",
+        "Cookie: " + dice_cookie,
+        "Referer: https://www.dice.com/jobs",
+
+        // Create a device that looks more like a real browser
+        "Sec-CH-UA: \"Google Chrome\";v=\"113\", \"Chromium\";v=\"113\"",
+        "Sec-CH-UA-Mobile: ?0",
+        "Sec-CH-UA-Platform: \"Windows\""};
+
+    // Timeout settings
+    request.timeout_seconds = 30;
+    request.connect_timeout_seconds = 10;
+    return request;
+}
+
 // Special function to fetch Dice job details
 // Improved fetch_dice_job_details function
 json fetch_dice_job_details(const std::string &job_url, const SiteConfig &site_config, const SearchConfig &search_cfg)
+{
+    reset_dice_session_if_failing();
+
+    std::cout << "  Fetching Dice job details from: " << job_url << std::endl;
+
+    return parse_dice_job_details(job_url, fetch_engine->fetch(dice_detail_request(job_url)).get());
+}
+
+// Extract the description from a fetched Dice job page, keeping count of
+// the responses Dice refused
+json parse_dice_job_details(const std::string &job_url, const FetchResult &result)
 {
     json job_details;
-    static int failure_count = 0;
-    static int success_count = 0;
-    static bool reset_session = false;
+    int &failure_count = dice_failure_count;
+    int &success_count = dice_success_count;
+    const std::string &buffer = result.body;
 
     try
     {
-        // Check if we need to reset the session due to too many failures
-        if (failure_count > 3 && success_count < 1)
+        if (result.curl_code == CURLE_OK)
         {
-            std::cout << "  Too many consecutive Dice failures. Resetting session..." << std::endl;
-            reset_session = true;
-            failure_count = 0;
-
-            // Sleep for a longer period to reset the session
-            std::this_thread::sleep_for(std::chrono::minutes(2));
-        }
-
-        std::cout << "  Fetching Dice job details from: " << job_url << std::endl;
+            long http_code = result.http_code;
 
-        // Add longer delay for Dice
-        std::this_thread::sleep_for(std::chrono::seconds(4 + (std::rand() % 4)));
-
-        // Special headers for Dice
-        std::vector<std::string> dice_user_agents = {
-            "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/123.0.0.0 Safari/537.36",
-            "Mozilla/5.0 (Macintosh; Intel Mac OS X 10_15_7) AppleWebKit/605.1.15 (KHTML, like Gecko) Version/17.4 Safari/605.1.15",
-            "Mozilla/5.0 (Windows NT 10.0; Win64; x64; rv:124.0) Gecko/20100101 Firefox/124.0"};
-
-        // Initialize CURL for Dice
-        CURL *curl = curl_easy_init();
-        std::string buffer;
-
-        if (curl)
-        {
-            curl_easy_setopt(curl, CURLOPT_URL, job_url.c_str());
-            curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
-            curl_easy_setopt(curl, CURLOPT_WRITEDATA, &buffer);
-            curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-
-            // Set a very browser-like user agent for Dice
-            std::string user_agent = dice_user_agents[std::rand() % dice_user_agents.size()];
-            curl_easy_setopt(curl, CURLOPT_USERAGENT, user_agent.c_str());
-
-            // Create cookies that look more like a real browser session
-            std::string session_id = generate_random_string(32);
-            std::string visitor_id = generate_random_string(16);
-            std::string dice_cookie = "dice.search-id=" + session_id +
-                                      "; dice.visitor-id=" + visitor_id +
-                                      "; dice.session-started=true";
-
-            // Set up headers for Dice
-            struct curl_slist *headers = NULL;
-            headers = curl_slist_append(headers, "Accept: text/html,application/xhtml+xml,application/xml;q=0.9,image/webp,*/*;q=0.8");
-            headers = curl_slist_append(headers, "Accept-Language: en-US,en;q=0.5");
-            headers = curl_slist_append(headers, "Connection: keep-alive");
-            headers = curl_slist_append(headers, "Upgrade-Insecure-Requests: 1");
-            headers = curl_slist_append(headers, "Cache-Control: max-age=0");
-            headers = curl_slist_append(headers, "Sec-Fetch-Dest: document");
-            headers = curl_slist_append(headers, "Sec-Fetch-Mode: navigate");
-            headers = curl_slist_append(headers, "Sec-Fetch-Site: same-origin");
-            headers = curl_slist_append(headers, "Sec-Fetch-User: ?1");
-            headers = curl_slist_append(headers, ("Cookie: " + dice_cookie).c_str());
-            headers = curl_slist_append(headers, "Referer: https://www.dice.com/jobs");
-
-            // Create a device that looks more like a real browser
-            headers = curl_slist_append(headers, "Sec-CH-UA: \"Google Chrome\";v=\"113\", \"Chromium\";v=\"113\"");
-            headers = curl_slist_append(headers, "Sec-CH-UA-Mobile: ?0");
-            headers = curl_slist_append(headers, "Sec-CH-UA-Platform: \"Windows\"");
-
-            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-
-            // Timeout settings
-            curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
-            curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 10L);
-
-            // Execute request
-            CURLcode res = curl_easy_perform(curl);
-
-            if (res == CURLE_OK)
-            {
-                long http_code = 0;
-                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-
-                if (http_code >= 200 && http_code < 300)
+            if (http_code >= 200 && http_code < 300)
+            {
+                // Save the response for debugging
+                std::string debug_path = "debug_dice_success_" +
+                                         std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + ".html";
+                std::ofstream debug_file(debug_path);
+                if (debug_file.is_open())
                 {
-                    // Save the response for debugging
-                    std::string debug_path = "debug_dice_success_" +
-                                             std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + ".html";
-                    std::ofstream debug_file(debug_path);
-                    if (debug_file.is_open())
-                    {
-                        debug_file << buffer;
-                        debug_file.close();
-                        std::cout << "  Saved successful Dice response to: " << debug_path << std::endl;
-                    }
-
-                    // Process the HTML as normal
-                    // ... (parse HTML with Gumbo, extract description, etc.)
-
-                    success_count++;
-                    failure_count = 0; // Reset failure count on success
+                    debug_file << buffer;
+                    debug_file.close();
+                    std::cout << "  Saved successful Dice response to: " << debug_path << std::endl;
                 }
-                else
-                {
-                    std::cerr << "  Dice HTTP error: " << http_code << std::endl;
-
-                    // Save error response for debugging
-                    std::string error_path = "debug_dice_error_" +
-                                             std::to_string(http_code) + "_" +
-                                             std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + ".html";
-                    std::ofstream error_file(error_path);
-                    if (error_file.is_open())
-                    {
-                        error_file << buffer;
-                        error_file.close();
-                        std::cout << "  Saved Dice error response to: " << error_path << std::endl;
-                    }
 
-                    failure_count++;
-                }
+                success_count++;
+                failure_count = 0; // Reset failure count on success
             }
             else
             {
-                std::cerr << "  Dice CURL error: " << curl_easy_strerror(res) << std::endl;
+                std::cerr << "  Dice HTTP error: " << http_code << std::endl;
+
+                // Save error response for debugging
+                std::string error_path = "debug_dice_error_" +
+                                         std::to_string(http_code) + "_" +
+                                         std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + ".html";
+                std::ofstream error_file(error_path);
+                if (error_file.is_open())
+                {
+                    error_file << buffer;
+                    error_file.close();
+                    std::cout << "  Saved Dice error response to: " << error_path << std::endl;
+                }
+
                 failure_count++;
             }
-
-            curl_slist_free_all(headers);
-            curl_easy_cleanup(curl);
+        }
+        else
+        {
+            std::cerr << "  Dice CURL error: " << curl_easy_strerror(result.curl_code) << std::endl;
+            failure_count++;
         }
 
         // Parse HTML with Gumbo
@@ -2122,7 +2081,7 @@ json fetch_dice_job_details(const std::string &job_url, const SiteConfig &site_c
     }
     catch (const std::exception &e)
     {
-        std::cerr << "Error fetching Dice job details: " << e.what() << std::endl;
+        std::cerr << "Error parsing Dice job details: " << e.what() << std::endl;
         failure_count++;
     }
 
@@ -2401,6 +2360,125 @@ bool save_to_sqlite(const std::vector<json> &jobs, const std::string &db_path)
 }
 #endif // ENABLE_SQLITE
 
+// Scrape a site without a dedicated processor using its SiteConfig selectors
+void process_generic_jobs(const SiteConfig &site, const SearchConfig &search_cfg,
+                          std::vector<json> &all_jobs, int max_jobs)
+{
+    std::cout << "Scraping from: " << site.name << std::endl;
+
+    // Format search URL with job title and location
+    std::string base_search_url = format_url(site.search_url_template,
+                                             search_cfg.job_title,
+                                             search_cfg.location);
+
+    // Process multiple pages up to max_pages
+    for (int page = 1; page <= site.max_pages; ++page)
+    {
+        // Construct pagination URL
+        std::string page_url = base_search_url;
+        if (!site.pagination_param.empty())
+        {
+            char separator = (page_url.find('?') != std::string::npos) ? '&' : '?';
+            page_url += separator + site.pagination_param + "=" + std::to_string(page);
+        }
+
+        std::cout << "  Fetching page " << page << ": " << page_url << std::endl;
+
+        // Fetch page HTML content
+        std::string html;
+        try
+        {
+            html = fetch_page(page_url, 3, site.name);
+
+            // Save HTML for debugging
+            std::string debug_path = "debug_" + site.name + "_page" + std::to_string(page) + "_" +
+                                     std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + ".html";
+            std::ofstream debug_file(debug_path);
+            if (debug_file.is_open())
+            {
+                debug_file << html;
+                debug_file.close();
+                std::cout << "  Saved " << site.name << " HTML to: " << debug_path << std::endl;
+            }
+        }
+        catch (const ScraperException &e)
+        {
+            std::cerr << "  Error fetching page: " << e.what() << std::endl;
+            break;
+        }
+
+        // Parse HTML with Gumbo
+        GumboOutput *output = gumbo_parse(html.c_str());
+        if (!output)
+        {
+            std::cerr << "  Failed to parse HTML for " << site.name << std::endl;
+            continue;
+        }
+
+        // Find job listing containers
+        std::vector<GumboNode *> containers;
+        find_nodes(output->root, site.container_tag, site.container_class, containers);
+
+        std::cout << "  Found " << containers.size() << " job listings" << std::endl;
+
+        // Extract job details from each container
+        for (auto *container : containers)
+        {
+            json job = scrape_details(container, site, search_cfg);
+
+            // Only add valid jobs
+            if (!job.empty())
+            {
+                all_jobs.push_back(job);
+
+                // Print basic info about the job
+                std::cout << "  Scraped: "
+                          << job.value("title", "Unknown Title") << " at "
+                          << job.value("company", "Unknown Company") << " in "
+                          << job.value("location", "Unknown Location") << std::endl;
+
+                // Break if we've reached the maximum number of jobs
+                if (all_jobs.size() >= static_cast<size_t>(max_jobs))
+                {
+                    std::cout << "  Reached maximum job limit (" << max_jobs << ")" << std::endl;
+                    break;
+                }
+            }
+        }
+
+        // Clean up Gumbo parser
+        gumbo_destroy_output(&kGumboDefaultOptions, output);
+
+        // Break if we've reached the maximum number of jobs
+        if (all_jobs.size() >= static_cast<size_t>(max_jobs))
+        {
+            break;
+        }
+    }
+}
+
+// Scrape one site with its specialized processor
+void process_site_jobs(const SiteConfig &site, const SearchConfig &search_cfg,
+                       std::vector<json> &all_jobs, int max_jobs)
+{
+    if (site.name == "LinkedIn")
+    {
+        process_linkedin_jobs(site, search_cfg, all_jobs, max_jobs);
+    }
+    else if (site.name == "SimplyHired")
+    {
+        process_simplyhired_jobs(site, search_cfg, all_jobs, max_jobs);
+    }
+    else if (site.name == "Dice")
+    {
+        process_dice_jobs(site, search_cfg, all_jobs, max_jobs);
+    }
+    else
+    {
+        process_generic_jobs(site, search_cfg, all_jobs, max_jobs);
+    }
+}
+
 // Function to configure job search sites
 std::vector<SiteConfig> initialize_site_configs()
 {
@@ -2430,9 +2508,14 @@ void print_help(char *program_name)
               << "  --output-dir DIR      Set output directory for files (default: ./output)\n"
               << "  --sqlite PATH         Enable SQLite output and set database path\n"
               << "  --interval HOURS      Set scraping interval in hours (default: 1)\n"
-              << "  --max-jobs N          Maximum number of jobs to scrape (default: 100)\n"
+              << "  --max-jobs N          Maximum number of jobs saved per run (default: 100). Sites are\n"
+              << "                        scraped at once, each for an even share (at least 5); a site\n"
+              << "                        that finds fewer does not pass its share on to the others\n"
               << "  --keyword WORD        Add keyword filter (can be used multiple times)\n"
               << "  --no-skills           Disable automatic skill extraction\n"
+              << "  --max-streams N       Concurrent requests per site, multiplexed over one HTTP/2\n"
+              << "                        connection where the site supports it (default: 8)\n"
+              << "  --http1               Do not negotiate HTTP/2\n"
               << "  --help                Show this help message\n";
 }
 
@@ -2446,6 +2529,7 @@ int main(int argc, char **argv)
     // Default configurations
     SearchConfig search_cfg;
     OutputConfig output_cfg;
+    FetchEngineOptions fetch_options;
 
     // Initialize random number generator
     std::srand(static_cast<unsigned>(std::time(nullptr)));
@@ -2490,6 +2574,14 @@ int main(int argc, char **argv)
         {
             search_cfg.keywords.push_back(argv[++i]);
         }
+        else if (arg == "--max-streams" && i + 1 < argc)
+        {
+            fetch_options.max_streams_per_host = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--http1")
+        {
+            fetch_options.http2 = false;
+        }
 
         else if (arg == "--help")
         {
@@ -2507,6 +2599,10 @@ int main(int argc, char **argv)
     // Get site configurations
     auto sites = initialize_site_configs();
 
+    // All page fetches go through one engine so requests to different sites overlap
+    fetch_engine = std::make_unique<FetchEngine>(fetch_options);
+    configure_fetch_politeness(*fetch_engine, sites, static_cast<size_t>(fetch_options.max_streams_per_host));
+
     // Main scraping loop
     while (true)
     {
@@ -2522,79 +2618,73 @@ int main(int argc, char **argv)
             rotate_job_sites(sites);
             std::cout << "Randomized job site processing order" << std::endl;
         }
-        int num_active_sites = 0;
+
+        std::vector<const SiteConfig *> active_sites;
         for (const auto &site : sites)
         {
+            // Skip sites that don't match the target_site parameter (if specified)
             if (search_cfg.target_site.empty() || site.name == search_cfg.target_site)
             {
-                if (site.name == "LinkedIn" || site.name == "SimplyHired" || site.name == "Dice")
-                {
-                    num_active_sites++;
-                }
+                active_sites.push_back(&site);
             }
         }
 
         // Calculate jobs per site (with a minimum to ensure we get some from each)
-        int jobs_per_site = std::max<int>(5, output_cfg.max_jobs / (num_active_sites > 0 ? num_active_sites : 1));
+        int jobs_per_site = std::max<int>(5, output_cfg.max_jobs / std::max<int>(1, static_cast<int>(active_sites.size())));
         std::cout << "Distributing approximately " << jobs_per_site << " jobs per site" << std::endl;
 
-        // Track jobs collected per site for logging
-        std::map<std::string, int> jobs_collected;
-
-        // Process each job site
-        for (const auto &site : sites)
+        // Scrape every site at once. Each one only waits for its own turns in
+        // the fetch engine, so a run takes as long as the slowest site rather
+        // than all of them back to back.
+        std::vector<std::future<std::vector<json>>> site_jobs;
+        for (size_t i = 0; i < active_sites.size(); ++i)
         {
-            // Skip sites that don't match the target_site parameter (if specified)
-            if (!search_cfg.target_site.empty() && site.name != search_cfg.target_site)
-            {
-                continue;
-            }
-
-            // Skip any sites that aren't the ones we want
-            if (site.name != "LinkedIn" && site.name != "SimplyHired" && site.name != "Dice")
+            const SiteConfig *site = active_sites[i];
+            unsigned seed = static_cast<unsigned>(std::rand()) + static_cast<unsigned>(i);
+            auto scrape_site = [&search_cfg, site, jobs_per_site, seed]()
             {
-                continue;
-            }
+                // The C runtime may keep rand() state per thread
+                std::srand(seed);
+                std::vector<json> jobs;
+                process_site_jobs(*site, search_cfg, jobs, jobs_per_site);
+                return jobs;
+            };
+            site_jobs.push_back(std::async(std::launch::async, scrape_site));
+        }
 
-            // Store the current size before processing this site
-            size_t initial_size = all_jobs.size();
+        // Track jobs collected per site for logging
+        std::map<std::string, int> jobs_collected;
 
+        // Gather the results in site order
+        std::vector<std::vector<json>> collected(active_sites.size());
+        for (size_t i = 0; i < active_sites.size(); ++i)
+        {
+            const SiteConfig &site = *active_sites[i];
             try
             {
-                // Use specialized processor for each site
-                if (site.name == "LinkedIn")
-                {
-                    process_linkedin_jobs(site, search_cfg, all_jobs, jobs_per_site);
-                }
-                else if (site.name == "SimplyHired")
-                {
-                    process_simplyhired_jobs(site, search_cfg, all_jobs, jobs_per_site);
-                }
-                else if (site.name == "Dice")
-                {
-                    process_dice_jobs(site, search_cfg, all_jobs, jobs_per_site);
-                }
-
-                // Log how many jobs we got from this site
-                jobs_collected[site.name] = all_jobs.size() - initial_size;
-                std::cout << "Collected " << jobs_collected[site.name] << " jobs from " << site.name << std::endl;
+                collected[i] = site_jobs[i].get();
+                jobs_collected[site.name] = static_cast<int>(collected[i].size());
+                std::cout << "Collected " << collected[i].size() << " jobs from " << site.name << std::endl;
             }
             catch (const std::exception &e)
             {
                 std::cerr << "Error scraping " << site.name << ": " << e.what() << std::endl;
             }
+        }
 
-            // Break if we've reached the maximum number of jobs across all sites
-            // Keep this as a safety check for the overall limit
-            if (all_jobs.size() >= static_cast<size_t>(output_cfg.max_jobs))
+        // Interleave the sites so that trimming to max_jobs below cuts each
+        // one back evenly instead of dropping the last sites altogether
+        for (size_t round = 0, added = 1; added > 0; ++round)
+        {
+            added = 0;
+            for (auto &jobs : collected)
             {
-                std::cout << "Reached overall maximum job limit (" << output_cfg.max_jobs << ")" << std::endl;
-                break;
+                if (round < jobs.size())
+                {
+                    all_jobs.push_back(std::move(jobs[round]));
+                    ++added;
+                }
             }
-
-            // Add a longer delay between different sites to avoid detection
-            std::cout << "Adding delay between job sites..." << std::endl;
-            std::this_thread::sleep_for(std::chrono::seconds(15 + (std::rand() % 15)));
         }
 
         // Print summary of jobs collected from each site
@@ -2603,155 +2693,6 @@ int main(int argc, char **argv)
         {
             std::cout << site_name << ": " << count << " jobs" << std::endl;
         }
-        // Process each job site
-        for (const auto &site : sites)
-        {
-            // Skip sites that don't match the target_site parameter (if specified)
-            if (!search_cfg.target_site.empty() && site.name != search_cfg.target_site)
-            {
-                continue;
-            }
-
-            try
-            {
-                // Use specialized processor for each site
-                if (site.name == "LinkedIn")
-                {
-                    process_linkedin_jobs(site, search_cfg, all_jobs, output_cfg.max_jobs);
-                }
-
-                else if (site.name == "SimplyHired")
-                {
-                    process_simplyhired_jobs(site, search_cfg, all_jobs, output_cfg.max_jobs);
-                }
-                else if (site.name == "Dice")
-                {
-                    // Add Dice processor function call here when implemented
-                    process_dice_jobs(site, search_cfg, all_jobs, output_cfg.max_jobs);
-                }
-                else
-                {
-                    // Use the regular processing logic for other sites
-                    std::cout << "Scraping from: " << site.name << std::endl;
-
-                    // Format search URL with job title and location
-                    std::string base_search_url = format_url(site.search_url_template,
-                                                             search_cfg.job_title,
-                                                             search_cfg.location);
-
-                    // Process multiple pages up to max_pages
-                    for (int page = 1; page <= site.max_pages; ++page)
-                    {
-                        // Construct pagination URL
-                        std::string page_url = base_search_url;
-                        if (!site.pagination_param.empty())
-                        {
-                            char separator = (page_url.find('?') != std::string::npos) ? '&' : '?';
-                            page_url += separator + site.pagination_param + "=" + std::to_string(page);
-                        }
-
-                        std::cout << "  Fetching page " << page << ": " << page_url << std::endl;
-
-                        // Add random delay before request
-                        int delay_ms = 3000 + (std::rand() % 5000);
-                        std::cout << "  Waiting for " << delay_ms / 1000.0 << " seconds before request..." << std::endl;
-                        std::this_thread::sleep_for(std::chrono::milliseconds(delay_ms));
-
-                        // Fetch page HTML content
-                        std::string html;
-                        try
-                        {
-                            html = fetch_page(page_url, 3, site.name);
-
-                            // Save HTML for debugging
-                            std::string debug_path = "debug_" + site.name + "_page" + std::to_string(page) + "_" +
-                                                     std::to_string(std::chrono::system_clock::now().time_since_epoch().count()) + ".html";
-                            std::ofstream debug_file(debug_path);
-                            if (debug_file.is_open())
-                            {
-                                debug_file << html;
-                                debug_file.close();
-                                std::cout << "  Saved " << site.name << " HTML to: " << debug_path << std::endl;
-                            }
-                        }
-                        catch (const ScraperException &e)
-                        {
-                            std::cerr << "  Error fetching page: " << e.what() << std::endl;
-                            break;
-                        }
-
-                        // Parse HTML with Gumbo
-                        GumboOutput *output = gumbo_parse(html.c_str());
-                        if (!output)
-                        {
-                            std::cerr << "  Failed to parse HTML for " << site.name << std::endl;
-                            continue;
-                        }
-
-                        // Find job listing containers
-                        std::vector<GumboNode *> containers;
-                        find_nodes(output->root, site.container_tag, site.container_class, containers);
-
-                        std::cout << "  Found " << containers.size() << " job listings" << std::endl;
-
-                        // Extract job details from each container
-                        for (auto *container : containers)
-                        {
-                            json job = scrape_details(container, site, search_cfg);
-
-                            // Only add valid jobs
-                            if (!job.empty())
-                            {
-                                all_jobs.push_back(job);
-
-                                // Print basic info about the job
-                                std::cout << "  Scraped: "
-                                          << job.value("title", "Unknown Title") << " at "
-                                          << job.value("company", "Unknown Company") << " in "
-                                          << job.value("location", "Unknown Location") << std::endl;
-
-                                // Break if we've reached the maximum number of jobs
-                                if (all_jobs.size() >= static_cast<size_t>(output_cfg.max_jobs))
-                                {
-                                    std::cout << "  Reached maximum job limit (" << output_cfg.max_jobs << ")" << std::endl;
-                                    break;
-                                }
-                            }
-
-                            // Add a small delay between jobs
-                            std::this_thread::sleep_for(std::chrono::milliseconds(500 + (std::rand() % 1000)));
-                        }
-
-                        // Clean up Gumbo parser
-                        gumbo_destroy_output(&kGumboDefaultOptions, output);
-
-                        // Break if we've reached the maximum number of jobs
-                        if (all_jobs.size() >= static_cast<size_t>(output_cfg.max_jobs))
-                        {
-                            break;
-                        }
-
-                        // Respect the site's delay between requests to avoid being blocked
-                        std::this_thread::sleep_for(site.delay + std::chrono::milliseconds(std::rand() % 5000));
-                    }
-                }
-            }
-            catch (const std::exception &e)
-            {
-                std::cerr << "Error scraping " << site.name << ": " << e.what() << std::endl;
-            }
-
-            // Break if we've reached the maximum number of jobs across all sites
-            if (all_jobs.size() >= static_cast<size_t>(output_cfg.max_jobs))
-            {
-                std::cout << "Reached overall maximum job limit (" << output_cfg.max_jobs << ")" << std::endl;
-                break;
-            }
-
-            // Add a longer delay between different sites to avoid detection
-            std::cout << "Adding delay between job sites..." << std::endl;
-            std::this_thread::sleep_for(std::chrono::seconds(15 + (std::rand() % 15)));
-        }
 
         // Generate timestamped filename for output
         auto now = std::chrono::system_clock::now();
@@ -2766,6 +2707,13 @@ int main(int argc, char **argv)
         std::cout << "Filtered " << all_jobs.size() << " jobs down to " << unique_jobs.size()
                   << " unique jobs" << std::endl;
 
+        // The per-site minimum can add up to more than max_jobs
+        if (unique_jobs.size() > static_cast<size_t>(output_cfg.max_jobs))
+        {
+            unique_jobs.resize(output_cfg.max_jobs);
+            std::cout << "Kept the first " << output_cfg.max_jobs << " (--max-jobs)" << std::endl;
+        }
+
         // Save to JSON file
         if (output_cfg.json_output && !unique_jobs.empty())
         {
@@ -2816,7 +2764,8 @@ int main(int argc, char **argv)
         std::this_thread::sleep_for(output_cfg.scrape_interval);
     }
 
-    // Clean up CURL
+    // Clean up CURL, after the engine's handles
+    fetch_engine.reset();
     curl_global_cleanup();
 
     return 0;
@@ -0,0 +1,175 @@
+#include "skill_index.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <numeric>
+#include <unordered_set>
+
+// BM25 term-frequency saturation and length normalisation
+const float BM25_K1 = 1.2f;
+const float BM25_B = 0.75f;
+
+static bool is_stopword(const std::string& token) {
+    static const std::unordered_set<std::string> stopwords = {
+        "a", "an", "and", "as", "at", "by", "for", "from", "in", "of",
+        "on", "or", "the", "to", "with"
+    };
+    return stopwords.count(token) > 0;
+}
+
+static bool is_word_char(unsigned char c) {
+    // Bytes >= 0x80 belong to UTF-8 letters such as the accents in French titles
+    return std::isalnum(c) || c >= 0x80 || c == '+' || c == '#';
+}
+
+std::vector<std::string> tokenize_keywords(const std::string& text) {
+    std::vector<std::string> tokens;
+    std::string token;
+
+    auto flush = [&] {
+        if (!token.empty() && !is_stopword(token)) {
+            tokens.push_back(token);
+        }
+        token.clear();
+    };
+
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = static_cast<unsigned char>(text[i]);
+        if (is_word_char(c)) {
+            token.push_back(static_cast<char>(c < 0x80 ? std::tolower(c) : c));
+        } else if (c == '.' && !token.empty() && i + 1 < text.size() &&
+                   std::isalnum(static_cast<unsigned char>(text[i + 1]))) {
+            // Dots inside a word ("node.js", "asp.net"), not at sentence ends
+            token.push_back('.');
+        } else {
+            flush();
+        }
+    }
+    flush();
+    return tokens;
+}
+
+void SkillIndex::add(int64_t id, const std::string& title, const std::vector<std::string>& skills) {
+    std::unordered_map<uint32_t, uint32_t> counts;
+    uint32_t length = 0;
+
+    auto add_text = [&](const std::string& text) {
+        for (const std::string& token : tokenize_keywords(text)) {
+            auto inserted = dictionary_.emplace(token, static_cast<uint32_t>(postings_.size()));
+            if (inserted.second) {
+                postings_.emplace_back();
+            }
+            counts[inserted.first->second]++;
+            length++;
+        }
+    };
+
+    add_text(title);
+    for (const std::string& skill : skills) {
+        add_text(skill);
+    }
+
+    for (const auto& entry : counts) {
+        postings_[entry.first].push_back({id, entry.second});
+    }
+    doc_ids_.push_back(id);
+    doc_lengths_.push_back(length);
+}
+
+void SkillIndex::finalize() {
+    for (auto& list : postings_) {
+        std::sort(list.begin(), list.end(),
+                  [](const Posting& a, const Posting& b) { return a.id < b.id; });
+    }
+
+    std::vector<size_t> order(doc_ids_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return doc_ids_[a] < doc_ids_[b]; });
+    std::vector<int64_t> ids(order.size());
+    std::vector<uint32_t> lengths(order.size());
+    double total_length = 0.0;
+    for (size_t i = 0; i < order.size(); i++) {
+        ids[i] = doc_ids_[order[i]];
+        lengths[i] = doc_lengths_[order[i]];
+        total_length += lengths[i];
+    }
+    doc_ids_.swap(ids);
+    doc_lengths_.swap(lengths);
+    average_length_ = doc_ids_.empty() ? 0.0f : static_cast<float>(total_length / doc_ids_.size());
+
+    double n = static_cast<double>(doc_ids_.size());
+    idf_.resize(postings_.size());
+    for (size_t term = 0; term < postings_.size(); term++) {
+        double df = static_cast<double>(postings_[term].size());
+        idf_[term] = static_cast<float>(std::log(1.0 + (n - df + 0.5) / (df + 0.5)));
+    }
+}
+
+std::vector<uint32_t> SkillIndex::query_terms(const std::string& text) const {
+    std::vector<uint32_t> terms;
+    for (const std::string& token : tokenize_keywords(text)) {
+        auto it = dictionary_.find(token);
+        if (it != dictionary_.end()) {
+            terms.push_back(it->second);
+        }
+    }
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    return terms;
+}
+
+uint32_t SkillIndex::doc_length(int64_t id) const {
+    auto it = std::lower_bound(doc_ids_.begin(), doc_ids_.end(), id);
+    if (it == doc_ids_.end() || *it != id) {
+        return 0;
+    }
+    return doc_lengths_[it - doc_ids_.begin()];
+}
+
+void SkillIndex::score(const std::vector<uint32_t>& terms, const int64_t* ids, size_t count,
+                       float* scores) const {
+    std::fill(scores, scores + count, 0.0f);
+    if (terms.empty() || count == 0 || average_length_ <= 0.0f) {
+        return;
+    }
+
+    // Visit the candidates in id order so each posting list is walked forward once
+    static thread_local std::vector<size_t> order;
+    static thread_local std::vector<float> norms;
+    order.resize(count);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) { return ids[a] < ids[b]; });
+
+    // Per-candidate length normalisation, shared by every term
+    norms.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        norms[i] = BM25_K1 * (1.0f - BM25_B + BM25_B * doc_length(ids[i]) / average_length_);
+    }
+
+    for (uint32_t term : terms) {
+        const std::vector<Posting>& list = postings_[term];
+        auto it = list.begin();
+        for (size_t i : order) {
+            it = std::lower_bound(it, list.end(), ids[i],
+                                  [](const Posting& p, int64_t id) { return p.id < id; });
+            if (it == list.end()) {
+                break;
+            }
+            if (it->id == ids[i]) {
+                float tf = static_cast<float>(it->tf);
+                scores[i] += idf_[term] * tf * (BM25_K1 + 1.0f) / (tf + norms[i]);
+            }
+        }
+    }
+}
+
+size_t SkillIndex::matching_jobs(const std::vector<uint32_t>& terms, IdFilter& filter) const {
+    size_t visited = 0;
+    for (uint32_t term : terms) {
+        for (const Posting& posting : postings_[term]) {
+            filter.add(posting.id);
+        }
+        visited += postings_[term].size();
+    }
+    return visited;
+}
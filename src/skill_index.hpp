@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "id_filter.hpp"
+
+// Split text into lowercase keyword tokens. Letters, digits and the
+// characters + # . inside a word are kept, so "C++", "C#" and "Node.js"
+// survive as terms; a few English stopwords are dropped.
+std::vector<std::string> tokenize_keywords(const std::string& text);
+
+// In-memory inverted index over the words of each job's skills and title,
+// scored with BM25. Posting lists hold (job id, term frequency) sorted by
+// job id, so scoring a candidate set is a merge-style intersection with each
+// query term's list rather than a pass over every job.
+class SkillIndex {
+public:
+    // Index one job. Ids may arrive in any order; call finalize() after the last add().
+    void add(int64_t id, const std::string& title, const std::vector<std::string>& skills);
+    // Sort the posting lists and compute the collection statistics
+    void finalize();
+
+    // Dictionary ids of the distinct tokens in text; tokens no job uses are dropped
+    std::vector<uint32_t> query_terms(const std::string& text) const;
+
+    // BM25 of each of count candidate ids against the query terms; ids
+    // without any of the terms (or unknown to the index) score 0
+    void score(const std::vector<uint32_t>& terms, const int64_t* ids, size_t count, float* scores) const;
+
+    // Add every job holding at least one of the terms to filter; returns
+    // how many postings were visited
+    size_t matching_jobs(const std::vector<uint32_t>& terms, IdFilter& filter) const;
+
+    size_t size() const { return doc_ids_.size(); }
+    size_t term_count() const { return postings_.size(); }
+
+private:
+    struct Posting {
+        int64_t id;
+        uint32_t tf;
+    };
+
+    // Length of job id in tokens, or 0 when it is not indexed
+    uint32_t doc_length(int64_t id) const;
+
+    std::unordered_map<std::string, uint32_t> dictionary_;
+    std::vector<std::vector<Posting>> postings_;
+    std::vector<float> idf_;
+    // Indexed job ids, ascending after finalize(), with their token counts
+    std::vector<int64_t> doc_ids_;
+    std::vector<uint32_t> doc_lengths_;
+    float average_length_ = 0.0f;
+};
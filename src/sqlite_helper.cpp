@@ -1,44 +1,385 @@
 #include "sqlite_helper.hpp"
 #include <sqlite3.h>
+#include <algorithm>
 #include <iostream>
+#include <unordered_map>
+#include <nlohmann/json.hpp>
+
+using json = nlohmann::json;
+
+// Ids bound per IN (...) query; stays under SQLITE_MAX_VARIABLE_NUMBER on old builds
+const size_t DETAIL_BATCH_SIZE = 500;
+
+static std::string column_string(sqlite3_stmt* stmt, int col) {
+    const unsigned char* text = sqlite3_column_text(stmt, col);
+    if (!text) {
+        return std::string();
+    }
+    // The byte count spares a strlen over long descriptions
+    return std::string(reinterpret_cast<const char*>(text), static_cast<size_t>(sqlite3_column_bytes(stmt, col)));
+}
+
+// Parse the (id, embedding) columns of the current row onto ids/vectors.
+// The embedding is one flat array or, for a long job, an array of chunk
+// vectors, each appended as its own row under the job's id. The first valid
+// row fixes dimension when it is still 0.
+static bool append_embedding_row(sqlite3_stmt* stmt, std::vector<int64_t>& ids,
+                                 std::vector<float>& vectors, int& dimension) {
+    int64_t id = sqlite3_column_int64(stmt, 0);
+    std::vector<std::vector<float>> chunks;
+
+    try {
+        json parsed = json::parse(column_string(stmt, 1));
+        if (!parsed.empty() && parsed.front().is_array()) {
+            chunks = parsed.get<std::vector<std::vector<float>>>();
+        } else {
+            chunks.push_back(parsed.get<std::vector<float>>());
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "[SQLite] Skipping job " << id << " with unreadable embedding: " << e.what() << "\n";
+        return false;
+    }
+
+    if (dimension == 0) {
+        dimension = static_cast<int>(chunks.front().size());
+    }
+    for (const std::vector<float>& chunk : chunks) {
+        if (chunk.empty() || static_cast<int>(chunk.size()) != dimension) {
+            return false;
+        }
+    }
+
+    for (const std::vector<float>& chunk : chunks) {
+        ids.push_back(id);
+        vectors.insert(vectors.end(), chunk.begin(), chunk.end());
+    }
+    return true;
+}
 
 sqlite3* open_database(const std::string& db_path) {
     sqlite3* db;
     if (sqlite3_open(db_path.c_str(), &db) != SQLITE_OK) {
         std::cerr << "[SQLite] Cannot open DB: " << sqlite3_errmsg(db) << "\n";
+        sqlite3_close(db);
         return nullptr;
     }
     return db;
 }
 
-bool fetch_job_details(sqlite3* db, int job_id, 
-                      std::string& title, std::string& description,
-                      std::string& location, std::string& source) {
-    std::string sql = "SELECT title, description, location, source FROM jobs WHERE id = ?";
+bool load_job_embeddings(sqlite3* db, std::vector<int64_t>& ids,
+                         std::vector<float>& vectors, int& dimension) {
+    const char* sql = "SELECT id, embedding FROM jobs WHERE embedding IS NOT NULL";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "[SQLite] Failed to prepare statement: " << sqlite3_errmsg(db) << "\n";
+        return false;
+    }
+
+    ids.clear();
+    vectors.clear();
+    dimension = 0;
+    size_t skipped = 0;
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        if (!append_embedding_row(stmt, ids, vectors, dimension)) {
+            skipped++;
+        }
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (skipped > 0) {
+        std::cerr << "[SQLite] Skipped " << skipped << " jobs with missing or mismatched embeddings\n";
+    }
+    return true;
+}
+
+bool load_job_embeddings_by_id(sqlite3* db, const std::vector<int64_t>& wanted,
+                               std::vector<int64_t>& ids, std::vector<float>& vectors, int& dimension) {
+    const char* sql = "SELECT id, embedding FROM jobs WHERE id = ? AND embedding IS NOT NULL";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "[SQLite] Failed to prepare statement: " << sqlite3_errmsg(db) << "\n";
+        return false;
+    }
+
+    ids.clear();
+    vectors.clear();
+    size_t skipped = 0;
+
+    for (int64_t id : wanted) {
+        sqlite3_bind_int64(stmt, 1, id);
+        if (sqlite3_step(stmt) == SQLITE_ROW && !append_embedding_row(stmt, ids, vectors, dimension)) {
+            skipped++;
+        }
+        sqlite3_reset(stmt);
+    }
+
+    sqlite3_finalize(stmt);
+
+    if (skipped > 0) {
+        std::cerr << "[SQLite] Skipped " << skipped << " jobs with missing or mismatched embeddings\n";
+    }
+    return true;
+}
+
+// SQL expression for when a job was stored, as local "YYYY-MM-DD HH:MM:SS"
+// text. scrapper.cpp writes a local scraped_at; embedder.py only has the
+// UTC created_at default, converted here. NULL when the table has neither.
+static std::string job_timestamp_expression(sqlite3* db) {
+    sqlite3_stmt* stmt;
+    if (sqlite3_prepare_v2(db, "PRAGMA table_info(jobs)", -1, &stmt, nullptr) != SQLITE_OK) {
+        return "NULL";
+    }
+    bool has_scraped_at = false;
+    bool has_created_at = false;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        std::string column = column_string(stmt, 1);
+        has_scraped_at = has_scraped_at || column == "scraped_at";
+        has_created_at = has_created_at || column == "created_at";
+    }
+    sqlite3_finalize(stmt);
+
+    if (has_scraped_at) {
+        return "scraped_at";
+    }
+    if (has_created_at) {
+        return "datetime(created_at, 'localtime')";
+    }
+    return "NULL";
+}
+
+bool load_embedded_job_ids(sqlite3* db, std::vector<int64_t>& ids, int max_age_days) {
+    std::string sql = "SELECT id FROM jobs WHERE embedding IS NOT NULL";
+    if (max_age_days > 0) {
+        // Rows without a timestamp never expire
+        std::string stored = job_timestamp_expression(db);
+        sql += " AND (" + stored + " IS NULL OR " + stored + " = '' OR " + stored +
+               " >= datetime('now', 'localtime', ?))";
+    }
+    sql += " ORDER BY id";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "[SQLite] Failed to prepare statement: " << sqlite3_errmsg(db) << "\n";
+        return false;
+    }
+
+    std::string age_modifier = "-" + std::to_string(max_age_days) + " days";
+    if (max_age_days > 0) {
+        sqlite3_bind_text(stmt, 1, age_modifier.c_str(), -1, SQLITE_STATIC);
+    }
+
+    ids.clear();
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        ids.push_back(sqlite3_column_int64(stmt, 0));
+    }
+
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+bool load_job_keywords(sqlite3* db, std::vector<int64_t>& ids, std::vector<std::string>& titles,
+                       std::vector<std::vector<std::string>>& skills) {
+    const char* sql = "SELECT id, title, skills FROM jobs WHERE embedding IS NOT NULL ORDER BY id";
     sqlite3_stmt* stmt;
-    
+
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "[SQLite] Failed to prepare statement: " << sqlite3_errmsg(db) << "\n";
+        return false;
+    }
+
+    ids.clear();
+    titles.clear();
+    skills.clear();
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        ids.push_back(sqlite3_column_int64(stmt, 0));
+        titles.push_back(column_string(stmt, 1));
+        skills.push_back(parse_skills(column_string(stmt, 2)));
+    }
+
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+bool load_job_attributes(sqlite3* db, JobAttributes& attributes) {
+    std::string sql = "SELECT id, location, source, " + job_timestamp_expression(db) +
+                      " FROM jobs WHERE embedding IS NOT NULL";
+    sqlite3_stmt* stmt;
+
     if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
         std::cerr << "[SQLite] Failed to prepare statement: " << sqlite3_errmsg(db) << "\n";
         return false;
     }
-    
+
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+        attributes.add(sqlite3_column_int64(stmt, 0), column_string(stmt, 1),
+                       column_string(stmt, 2), column_string(stmt, 3));
+    }
+
+    sqlite3_finalize(stmt);
+    return true;
+}
+
+bool query_embedding_watermark(sqlite3* db, int64_t& count, int64_t& max_id) {
+    const char* sql = "SELECT COUNT(*), COALESCE(MAX(id), 0) FROM jobs WHERE embedding IS NOT NULL";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql, -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "[SQLite] Failed to prepare statement: " << sqlite3_errmsg(db) << "\n";
+        return false;
+    }
+
+    bool success = sqlite3_step(stmt) == SQLITE_ROW;
+    if (success) {
+        count = sqlite3_column_int64(stmt, 0);
+        max_id = sqlite3_column_int64(stmt, 1);
+    }
+
+    sqlite3_finalize(stmt);
+    return success;
+}
+
+std::vector<std::string> parse_skills(const std::string& raw) {
+    std::vector<std::string> skills;
+    if (raw.empty()) {
+        return skills;
+    }
+
+    if (raw.front() == '[') {
+        json parsed = json::parse(raw, nullptr, false);
+        if (parsed.is_array()) {
+            for (const auto& skill : parsed) {
+                if (skill.is_string()) {
+                    skills.push_back(skill.get<std::string>());
+                }
+            }
+            return skills;
+        }
+    }
+
+    size_t start = 0;
+    while (start <= raw.size()) {
+        size_t end = raw.find(',', start);
+        if (end == std::string::npos) {
+            end = raw.size();
+        }
+        size_t first = raw.find_first_not_of(" \t", start);
+        size_t last = raw.find_last_not_of(" \t", end - 1);
+        if (first != std::string::npos && first < end && last >= first) {
+            skills.push_back(raw.substr(first, last - first + 1));
+        }
+        start = end + 1;
+    }
+    return skills;
+}
+
+bool fetch_job_details(sqlite3* db, int job_id, Job& job) {
+    std::string sql = "SELECT title, description, location, source, skills FROM jobs WHERE id = ?";
+    sqlite3_stmt* stmt;
+
+    if (sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "[SQLite] Failed to prepare statement: " << sqlite3_errmsg(db) << "\n";
+        return false;
+    }
+
     sqlite3_bind_int(stmt, 1, job_id);
     bool success = false;
-    
+
     if (sqlite3_step(stmt) == SQLITE_ROW) {
-        title = sqlite3_column_text(stmt, 0) ? 
-               reinterpret_cast<const char*>(sqlite3_column_text(stmt, 0)) : "";
-        description = sqlite3_column_text(stmt, 1) ? 
-                     reinterpret_cast<const char*>(sqlite3_column_text(stmt, 1)) : "";
-        location = sqlite3_column_text(stmt, 2) ? 
-                  reinterpret_cast<const char*>(sqlite3_column_text(stmt, 2)) : "";
-        source = sqlite3_column_text(stmt, 3) ? 
-                reinterpret_cast<const char*>(sqlite3_column_text(stmt, 3)) : "";
+        job.id = job_id;
+        job.title = column_string(stmt, 0);
+        job.description = column_string(stmt, 1);
+        job.location = column_string(stmt, 2);
+        job.source = column_string(stmt, 3);
+        job.skills = parse_skills(column_string(stmt, 4));
         success = true;
     } else {
         std::cerr << "[SQLite] No job found with ID: " << job_id << "\n";
     }
-    
+
     sqlite3_finalize(stmt);
     return success;
-}
\ No newline at end of file
+}
+
+bool fetch_job_details_batch(ReadConnection& connection, const std::vector<int64_t>& job_ids,
+                             std::vector<Job>& jobs, size_t description_chars) {
+    jobs.clear();
+
+    std::vector<int64_t> wanted;
+    wanted.reserve(job_ids.size());
+    for (int64_t id : job_ids) {
+        if (id >= 0) {
+            wanted.push_back(id);
+        }
+    }
+
+    // Rows arrive in table order; each lands straight in the slot of its id
+    std::unordered_map<int64_t, size_t> slot_of;
+    slot_of.reserve(wanted.size());
+    for (size_t i = 0; i < wanted.size(); i++) {
+        slot_of.emplace(wanted[i], i);
+    }
+    std::vector<Job> slots(wanted.size());
+    std::vector<char> found(wanted.size(), 0);
+
+    std::string description_column = "description";
+    if (description_chars > 0) {
+        description_column = "substr(description, 1, " + std::to_string(description_chars) + ")";
+    }
+
+    for (size_t start = 0; start < wanted.size(); start += DETAIL_BATCH_SIZE) {
+        size_t end = std::min(wanted.size(), start + DETAIL_BATCH_SIZE);
+
+        std::string sql = "SELECT id, title, " + description_column +
+                          ", location, source, skills FROM jobs WHERE id IN (?";
+        for (size_t i = start + 1; i < end; i++) {
+            sql += ",?";
+        }
+        sql += ")";
+
+        ReadConnection::Statement statement = connection.prepare(sql);
+        if (!statement) {
+            return false;
+        }
+        sqlite3_stmt* stmt = statement.get();
+
+        for (size_t i = start; i < end; i++) {
+            sqlite3_bind_int64(stmt, static_cast<int>(i - start + 1), wanted[i]);
+        }
+
+        int rc;
+        while ((rc = sqlite3_step(stmt)) == SQLITE_ROW) {
+            int64_t id = sqlite3_column_int64(stmt, 0);
+            auto it = slot_of.find(id);
+            if (it == slot_of.end()) {
+                continue;
+            }
+            Job& job = slots[it->second];
+            job.id = static_cast<int>(id);
+            job.title = column_string(stmt, 1);
+            job.description = column_string(stmt, 2);
+            job.location = column_string(stmt, 3);
+            job.source = column_string(stmt, 4);
+            job.skills = parse_skills(column_string(stmt, 5));
+            found[it->second] = 1;
+        }
+        if (rc != SQLITE_DONE) {
+            // A locked or busy database is not the same as jobs having gone
+            std::cerr << "[SQLite] Failed to read job details: " << sqlite3_errstr(rc) << "\n";
+            return false;
+        }
+    }
+
+    jobs.reserve(wanted.size());
+    for (size_t i = 0; i < wanted.size(); i++) {
+        if (!found[i]) {
+            std::cerr << "[SQLite] No job found with ID: " << wanted[i] << "\n";
+            continue;
+        }
+        jobs.push_back(std::move(slots[i]));
+    }
+    return true;
+}
@@ -1,9 +1,56 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include <vector>
 #include <sqlite3.h>
+#include "cv_job_matcher.hpp"
+#include "job_attributes.hpp"
+#include "sqlite_pool.hpp"
 
 sqlite3* open_database(const std::string& db_path);
 
-bool fetch_job_details(sqlite3* db, int job_id, 
-                      std::string& title, std::string& description,
-                      std::string& location, std::string& source);
\ No newline at end of file
+// Load every job embedding stored in the jobs table into one row-major matrix.
+// ids[i] is the jobs.id of row i; rows whose dimension differs from the first
+// valid row are skipped. A job stored as a list of chunk vectors contributes
+// one row per chunk, all labelled with its id.
+bool load_job_embeddings(sqlite3* db, std::vector<int64_t>& ids,
+                         std::vector<float>& vectors, int& dimension);
+
+// Load the embeddings of the listed jobs only. A non-zero dimension on entry
+// is enforced; otherwise the first valid row sets it. Missing ids are skipped.
+bool load_job_embeddings_by_id(sqlite3* db, const std::vector<int64_t>& wanted,
+                               std::vector<int64_t>& ids, std::vector<float>& vectors, int& dimension);
+
+// Ids of jobs that carry an embedding, ascending. With max_age_days > 0, jobs
+// scraped (or, without scraped_at, created) longer ago than that are left out.
+bool load_embedded_job_ids(sqlite3* db, std::vector<int64_t>& ids, int max_age_days = 0);
+
+// Title and parsed skills of every job that carries an embedding, for the
+// keyword index. titles[i] and skills[i] belong to jobs.id ids[i].
+bool load_job_keywords(sqlite3* db, std::vector<int64_t>& ids, std::vector<std::string>& titles,
+                       std::vector<std::vector<std::string>>& skills);
+
+// Location, source and scraped_at of every job that carries an embedding.
+// Tables without scraped_at (embedder.py) supply created_at in local time,
+// or no date at all.
+bool load_job_attributes(sqlite3* db, JobAttributes& attributes);
+
+// Row count and highest id of jobs that carry an embedding; a cheap way to
+// tell whether a derived embedding store or index is out of date
+bool query_embedding_watermark(sqlite3* db, int64_t& count, int64_t& max_id);
+
+// Parse the skills column, which holds either a JSON array (embedder.py)
+// or a comma-separated list (scrapper.cpp)
+std::vector<std::string> parse_skills(const std::string& raw);
+
+bool fetch_job_details(sqlite3* db, int job_id, Job& job);
+
+// Hydrate many jobs with one query per chunk of ids instead of one prepared
+// statement per id. jobs comes back in the order of job_ids (score order for
+// search results); negative ids and ids with no row are left out.
+// The statements come from the connection's cache, so repeated calls with
+// the same number of ids do not prepare again. With description_chars > 0,
+// SQLite truncates each description to that many characters, so full
+// descriptions are never copied out of the database.
+bool fetch_job_details_batch(ReadConnection& connection, const std::vector<int64_t>& job_ids,
+                             std::vector<Job>& jobs, size_t description_chars = 0);
@@ -0,0 +1,94 @@
+#include "sqlite_pool.hpp"
+#include <iostream>
+
+ReadConnection::Statement::~Statement() {
+    if (stmt_) {
+        sqlite3_reset(stmt_);
+        sqlite3_clear_bindings(stmt_);
+    }
+}
+
+ReadConnection::~ReadConnection() {
+    for (auto& entry : statements_) {
+        sqlite3_finalize(entry.second);
+    }
+    if (db_) {
+        sqlite3_close(db_);
+    }
+}
+
+bool ReadConnection::open(const std::string& db_path, const ConnectionPoolOptions& options) {
+    int flags = SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX;
+    if (sqlite3_open_v2(db_path.c_str(), &db_, flags, nullptr) != SQLITE_OK) {
+        std::cerr << "[SQLite] Cannot open DB read-only: " << sqlite3_errmsg(db_) << "\n";
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return false;
+    }
+
+    // Serve reads from the OS page cache where possible and keep a larger
+    // private cache for the pages the mapping does not cover
+    std::string pragmas = "PRAGMA mmap_size = " + std::to_string(options.mmap_size) +
+                          "; PRAGMA cache_size = -" + std::to_string(options.cache_size_kib) + ";";
+    char* err_msg = nullptr;
+    if (sqlite3_exec(db_, pragmas.c_str(), nullptr, nullptr, &err_msg) != SQLITE_OK) {
+        std::cerr << "[SQLite] Failed to apply pragmas: " << (err_msg ? err_msg : "") << "\n";
+        sqlite3_free(err_msg);
+    }
+    return true;
+}
+
+ReadConnection::Statement ReadConnection::prepare(const std::string& sql) {
+    auto it = statements_.find(sql);
+    if (it != statements_.end()) {
+        return Statement(it->second);
+    }
+
+    sqlite3_stmt* stmt = nullptr;
+    if (sqlite3_prepare_v3(db_, sql.c_str(), -1, SQLITE_PREPARE_PERSISTENT, &stmt, nullptr) != SQLITE_OK) {
+        std::cerr << "[SQLite] Failed to prepare statement: " << sqlite3_errmsg(db_) << "\n";
+        return Statement();
+    }
+    statements_.emplace(sql, stmt);
+    return Statement(stmt);
+}
+
+ConnectionPool::Lease::~Lease() {
+    if (connection_) {
+        pool_->release(connection_);
+    }
+}
+
+bool ConnectionPool::open(const std::string& db_path, const ConnectionPoolOptions& options) {
+    size_t size = options.size > 0 ? options.size : 1;
+    for (size_t i = 0; i < size; i++) {
+        auto connection = std::make_unique<ReadConnection>();
+        if (!connection->open(db_path, options)) {
+            connections_.clear();
+            idle_.clear();
+            return false;
+        }
+        idle_.push_back(connection.get());
+        connections_.push_back(std::move(connection));
+    }
+    return true;
+}
+
+ConnectionPool::Lease ConnectionPool::acquire() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (connections_.empty()) {
+        return Lease(this, nullptr);
+    }
+    available_.wait(lock, [this] { return !idle_.empty(); });
+    ReadConnection* connection = idle_.back();
+    idle_.pop_back();
+    return Lease(this, connection);
+}
+
+void ConnectionPool::release(ReadConnection* connection) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.push_back(connection);
+    }
+    available_.notify_one();
+}
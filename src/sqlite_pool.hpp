@@ -0,0 +1,102 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sqlite3.h>
+
+struct ConnectionPoolOptions {
+    size_t size = 4;                       // Connections opened up front
+    int64_t mmap_size = 256LL << 20;       // PRAGMA mmap_size, bytes
+    int64_t cache_size_kib = 16 * 1024;    // PRAGMA cache_size, per connection
+};
+
+// A read-only SQLite connection (SQLITE_OPEN_READONLY | SQLITE_OPEN_NOMUTEX)
+// with its own prepared-statement cache. It is used by one thread at a time,
+// which the pool guarantees, so SQLite's own mutexes are left off.
+class ReadConnection {
+public:
+    // A cached statement, reset and unbound when it goes out of scope so the
+    // connection never holds a read transaction open between queries
+    class Statement {
+    public:
+        explicit Statement(sqlite3_stmt* stmt = nullptr) : stmt_(stmt) {}
+        ~Statement();
+        Statement(Statement&& other) noexcept : stmt_(other.stmt_) { other.stmt_ = nullptr; }
+        Statement(const Statement&) = delete;
+        Statement& operator=(const Statement&) = delete;
+        Statement& operator=(Statement&&) = delete;
+
+        sqlite3_stmt* get() const { return stmt_; }
+        explicit operator bool() const { return stmt_ != nullptr; }
+
+    private:
+        sqlite3_stmt* stmt_;
+    };
+
+    ReadConnection() = default;
+    ~ReadConnection();
+    ReadConnection(const ReadConnection&) = delete;
+    ReadConnection& operator=(const ReadConnection&) = delete;
+
+    bool open(const std::string& db_path, const ConnectionPoolOptions& options);
+
+    // Prepare sql once per connection and hand out the cached statement.
+    // Returns an empty Statement (and logs) if it does not compile.
+    Statement prepare(const std::string& sql);
+
+    sqlite3* handle() const { return db_; }
+
+private:
+    sqlite3* db_ = nullptr;
+    std::unordered_map<std::string, sqlite3_stmt*> statements_;
+};
+
+// Fixed set of read-only connections shared by matcher threads. acquire()
+// blocks until a connection is free; the lease gives it back on destruction.
+class ConnectionPool {
+public:
+    class Lease {
+    public:
+        Lease(ConnectionPool* pool, ReadConnection* connection) : pool_(pool), connection_(connection) {}
+        ~Lease();
+        Lease(Lease&& other) noexcept : pool_(other.pool_), connection_(other.connection_) {
+            other.connection_ = nullptr;
+        }
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+        Lease& operator=(Lease&&) = delete;
+
+        explicit operator bool() const { return connection_ != nullptr; }
+        ReadConnection& operator*() const { return *connection_; }
+        ReadConnection* operator->() const { return connection_; }
+
+    private:
+        ConnectionPool* pool_;
+        ReadConnection* connection_;
+    };
+
+    ConnectionPool() = default;
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    // Open options.size connections to db_path. Returns false (and logs) if
+    // any of them fails.
+    bool open(const std::string& db_path, const ConnectionPoolOptions& options = ConnectionPoolOptions());
+
+    // Empty lease if the pool was never opened
+    Lease acquire();
+    size_t size() const { return connections_.size(); }
+
+private:
+    void release(ReadConnection* connection);
+
+    std::vector<std::unique_ptr<ReadConnection>> connections_;
+    std::vector<ReadConnection*> idle_;
+    std::mutex mutex_;
+    std::condition_variable available_;
+};
@@ -0,0 +1,99 @@
+#include "thread_pool.hpp"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+size_t default_thread_count() {
+    unsigned int count = std::thread::hardware_concurrency();
+    return count > 0 ? count : 1;
+}
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = default_thread_count();
+    }
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; i++) {
+        workers_.emplace_back([this] { worker_loop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    available_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    available_.notify_one();
+}
+
+void ThreadPool::worker_loop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+
+void ThreadPool::parallel_for(size_t n, const std::function<void(size_t)>& fn) {
+    if (n == 0) {
+        return;
+    }
+
+    struct Shared {
+        std::atomic<size_t> next{0};
+        size_t done = 0;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto shared = std::make_shared<Shared>();
+
+    // Claim indices until none are left; returns how many this call ran
+    auto drain = [shared, n, &fn] {
+        size_t ran = 0;
+        for (size_t i = shared->next++; i < n; i = shared->next++) {
+            fn(i);
+            ran++;
+        }
+        return ran;
+    };
+    auto finish = [shared, n](size_t ran) {
+        if (ran == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(shared->mutex);
+        shared->done += ran;
+        if (shared->done == n) {
+            shared->finished.notify_all();
+        }
+    };
+
+    // fn outlives the helpers: the caller waits below until every index is done,
+    // and helpers that start late find nothing left to claim
+    size_t helpers = std::min(n - 1, workers_.size());
+    for (size_t h = 0; h < helpers; h++) {
+        submit([drain, finish] { finish(drain()); });
+    }
+
+    finish(drain());
+    std::unique_lock<std::mutex> lock(shared->mutex);
+    shared->finished.wait(lock, [&] { return shared->done == n; });
+}
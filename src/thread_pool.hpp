@@ -0,0 +1,41 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads draining a FIFO task queue
+class ThreadPool {
+public:
+    // threads == 0 uses one worker per hardware thread
+    explicit ThreadPool(size_t threads = 0);
+    // Runs every queued task, then joins the workers
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void submit(std::function<void()> task);
+
+    // Run fn(i) for every i in [0, n) on the workers and the calling thread,
+    // returning once all calls have finished. The caller claims work too, so
+    // this cannot deadlock when invoked from inside a worker.
+    void parallel_for(size_t n, const std::function<void(size_t)>& fn);
+
+    size_t size() const { return workers_.size(); }
+
+private:
+    void worker_loop();
+
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable available_;
+    bool stopping_ = false;
+};
+
+// Hardware thread count, at least 1
+size_t default_thread_count();
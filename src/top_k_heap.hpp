@@ -0,0 +1,47 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+// (score, row) entry of the bounded heaps the brute-force scans keep per query
+using ScoredRow = std::pair<float, size_t>;
+
+// Offer a scored row to a min-heap holding the best keep rows (the root is
+// the weakest). With row_ids, rows sharing an id (the chunks of one job)
+// occupy a single entry scored by the best of them, so the heap yields
+// distinct ids. The id lookup only runs for rows that beat the root.
+inline void offer_top_k(std::vector<ScoredRow>& heap, size_t keep, float score, size_t row,
+                        const int64_t* row_ids = nullptr) {
+    if (keep == 0 || (heap.size() >= keep && score <= heap.front().first)) {
+        return;
+    }
+    if (row_ids) {
+        for (ScoredRow& entry : heap) {
+            if (row_ids[entry.second] == row_ids[row]) {
+                if (score > entry.first) {
+                    entry = ScoredRow(score, row);
+                    std::make_heap(heap.begin(), heap.end(), std::greater<ScoredRow>());
+                }
+                return;
+            }
+        }
+    }
+    if (heap.size() < keep) {
+        heap.emplace_back(score, row);
+        std::push_heap(heap.begin(), heap.end(), std::greater<ScoredRow>());
+    } else {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<ScoredRow>());
+        heap.back() = ScoredRow(score, row);
+        std::push_heap(heap.begin(), heap.end(), std::greater<ScoredRow>());
+    }
+}
+
+// Whether any id labels more than one row
+inline bool has_repeated_ids(const int64_t* ids, size_t count) {
+    std::vector<int64_t> sorted(ids, ids + count);
+    std::sort(sorted.begin(), sorted.end());
+    return std::adjacent_find(sorted.begin(), sorted.end()) != sorted.end();
+}
@@ -0,0 +1,228 @@
+#include "rate_limiter.hpp"
+#include <chrono>
+#include <iostream>
+#include <atomic>
+#include <cmath>
+#include <set>
+#include <thread>
+#include <vector>
+
+using Clock = RateLimiter::Clock;
+using std::chrono::milliseconds;
+
+static bool expect(bool condition, const char* what) {
+    if (!condition) {
+        std::cerr << "expected " << what << "\n";
+    }
+    return condition;
+}
+
+static bool near(double value, double expected) {
+    return std::fabs(value - expected) < 1e-9;
+}
+
+// Drives one site's bucket on a simulated clock: every send waits for the
+// time try_acquire() names, and the gaps between sends must be at least the
+// interval, at most interval plus jitter, and not all the same.
+static bool test_jitter_adds_to_interval() {
+    const auto interval = std::chrono::milliseconds(1000);
+    const auto jitter = std::chrono::milliseconds(1000);
+
+    RateLimiter limiter;
+    RateLimit limit;
+    limit.interval = interval;
+    limit.jitter = jitter;
+    limiter.set_limit("site", limit);
+
+    Clock::time_point now = Clock::now();
+    std::vector<Clock::time_point> sends;
+    while (sends.size() < 50) {
+        Clock::time_point due = limiter.try_acquire("site", now);
+        if (due > now) {
+            now = due;
+            continue;
+        }
+        sends.push_back(now);
+    }
+
+    bool ok = true;
+    std::set<long long> gaps;
+    for (size_t i = 1; i < sends.size(); i++) {
+        auto gap = std::chrono::duration_cast<std::chrono::milliseconds>(sends[i] - sends[i - 1]);
+        gaps.insert(gap.count());
+        if (gap < interval || gap > interval + jitter) {
+            std::cerr << "gap " << i << " is " << gap.count() << " ms, outside [" << interval.count() << ", "
+                      << (interval + jitter).count() << "]\n";
+            ok = false;
+        }
+    }
+    if (gaps.size() < 2) {
+        std::cerr << "every gap is " << *gaps.begin() << " ms; jitter has no effect\n";
+        ok = false;
+    }
+    return ok;
+}
+
+// Throttling answers double the interval, up to the cap, and spend the burst
+static bool test_throttling_doubles_interval() {
+    RateLimiter limiter;
+    RateLimit limit;
+    limit.interval = milliseconds(1000);
+    limit.burst = 3.0;
+    limiter.set_limit("site", limit);
+    Clock::time_point now = Clock::now();
+
+    bool ok = true;
+    limiter.record("site", false, 429, now);
+    RateLimitInfo info = limiter.info("site");
+    ok &= expect(near(info.slowdown, 2.0), "slowdown 2 after a 429");
+    ok &= expect(info.backoff_mode, "backoff after a 429");
+    ok &= expect(info.tokens == 0.0, "no burst left after a 429");
+    // The next token is a doubled interval away
+    ok &= expect(limiter.try_acquire("site", now) == now + milliseconds(2000), "next token 2 s away");
+
+    limiter.record("site", false, 403, now);
+    ok &= expect(near(limiter.info("site").slowdown, 4.0), "slowdown 4 after a 403");
+    for (int i = 0; i < 10; i++) {
+        limiter.record("site", false, 999, now);
+    }
+    ok &= expect(near(limiter.info("site").slowdown, 16.0), "slowdown capped at 16");
+    return ok;
+}
+
+// Other failures slow the site by half only once they run three in a row,
+// and a missing page does not count at all
+static bool test_failures_slow_by_half() {
+    RateLimiter limiter;
+    RateLimit limit;
+    limit.interval = milliseconds(1000);
+    limiter.set_limit("site", limit);
+    Clock::time_point now = Clock::now();
+
+    bool ok = true;
+    limiter.record("site", false, 404, now);
+    limiter.record("site", false, 500, now);
+    limiter.record("site", false, 0, now);
+    ok &= expect(near(limiter.info("site").slowdown, 1.0), "no slowdown after two failures and a 404");
+    ok &= expect(!limiter.info("site").backoff_mode, "no backoff after two failures");
+    limiter.record("site", false, 503, now);
+    ok &= expect(near(limiter.info("site").slowdown, 1.5), "slowdown 1.5 after three failures");
+    ok &= expect(limiter.info("site").backoff_mode, "backoff after three failures");
+    limiter.record("site", false, 502, now);
+    ok &= expect(near(limiter.info("site").slowdown, 2.25), "slowdown 2.25 after four failures");
+
+    // A success breaks the run
+    limiter.record("site", true, 200, now);
+    limiter.record("site", false, 500, now);
+    limiter.record("site", false, 500, now);
+    ok &= expect(near(limiter.info("site").slowdown, 2.25), "two failures after a success change nothing");
+    return ok;
+}
+
+// Each run of successes in backoff halves the slowdown until it is back to 1
+static bool test_successes_recover() {
+    RateLimiter limiter;
+    RateLimit limit;
+    limit.interval = milliseconds(1000);
+    limiter.set_limit("site", limit);
+    Clock::time_point now = Clock::now();
+    limiter.record("site", false, 429, now);
+    limiter.record("site", false, 429, now);
+
+    bool ok = expect(near(limiter.info("site").slowdown, 4.0), "slowdown 4 after two 429s");
+    for (int i = 0; i < 3; i++) {
+        limiter.record("site", true, 200, now);
+    }
+    ok &= expect(near(limiter.info("site").slowdown, 4.0), "three successes are not yet enough");
+    limiter.record("site", true, 200, now);
+    ok &= expect(near(limiter.info("site").slowdown, 2.0), "slowdown 2 after four successes");
+    ok &= expect(limiter.info("site").backoff_mode, "still in backoff at slowdown 2");
+    for (int i = 0; i < 4; i++) {
+        limiter.record("site", true, 200, now);
+    }
+    RateLimitInfo info = limiter.info("site");
+    ok &= expect(near(info.slowdown, 1.0), "slowdown back to 1");
+    ok &= expect(!info.backoff_mode, "out of backoff");
+    return ok;
+}
+
+// A paused site gets nothing until the cooldown ends; other sites carry on
+static bool test_pause_holds_site() {
+    RateLimiter limiter;
+    RateLimit limit;
+    limit.interval = milliseconds(100);
+    limiter.set_limit("limited", limit);
+    Clock::time_point now = Clock::now();
+    const auto cooldown = std::chrono::seconds(120);
+
+    bool ok = true;
+    limiter.pause("limited", cooldown, now);
+    limiter.pause("unlimited", cooldown, now);
+    ok &= expect(limiter.try_acquire("limited", now + milliseconds(500)) == now + cooldown, "limited site held");
+    ok &= expect(limiter.try_acquire("unlimited", now + milliseconds(500)) == now + cooldown, "unlimited site held");
+    ok &= expect(limiter.try_acquire("other", now) == now, "other sites not held");
+    ok &= expect(limiter.try_acquire("limited", now + cooldown) == now + cooldown, "limited site granted after cooldown");
+    ok &= expect(limiter.try_acquire("unlimited", now + cooldown) == now + cooldown, "unlimited site granted after cooldown");
+
+    // A shorter pause does not cut a longer one short
+    limiter.pause("other", cooldown, now);
+    limiter.pause("other", milliseconds(10), now);
+    ok &= expect(limiter.try_acquire("other", now + milliseconds(20)) == now + cooldown, "longer pause kept");
+    return ok;
+}
+
+// Threads racing for one bucket at the same instant get exactly its burst
+static bool test_concurrent_acquire_respects_burst() {
+    RateLimiter limiter;
+    RateLimit limit;
+    limit.interval = std::chrono::hours(1);
+    limit.burst = 5.0;
+    limiter.set_limit("site", limit);
+    Clock::time_point now = Clock::now();
+
+    std::atomic<int> granted{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; i++) {
+                if (limiter.try_acquire("site", now) == now) {
+                    granted++;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    if (granted != 5) {
+        std::cerr << granted << " tokens granted from a burst of 5\n";
+        return false;
+    }
+    return true;
+}
+
+int main() {
+    struct Test {
+        const char* name;
+        bool (*run)();
+    };
+    const Test tests[] = {
+        {"jitter adds to interval", test_jitter_adds_to_interval},
+        {"throttling doubles interval", test_throttling_doubles_interval},
+        {"failures slow by half", test_failures_slow_by_half},
+        {"successes recover", test_successes_recover},
+        {"pause holds site", test_pause_holds_site},
+        {"concurrent acquire respects burst", test_concurrent_acquire_respects_burst},
+    };
+
+    int failed = 0;
+    for (const Test& test : tests) {
+        if (test.run()) {
+            std::cout << "[PASS] " << test.name << "\n";
+        } else {
+            std::cerr << "[FAIL] " << test.name << "\n";
+            failed++;
+        }
+    }
+    return failed == 0 ? 0 : 1;
+}